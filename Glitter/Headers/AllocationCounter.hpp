@@ -0,0 +1,7 @@
+#pragma once
+
+#include <cstddef>
+
+// Number of global operator new calls made by the calling thread so far. Only
+// counts when built with GLITTER_COUNT_ALLOCATIONS; otherwise always returns 0.
+std::size_t allocationCount();
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+// A bump allocator: allocations are a pointer increment into one fixed block
+// and are all released at once by reset(). Individual frees are no-ops.
+class LinearArena {
+public:
+  // What allocate() does once the block is full: throw std::bad_alloc, or
+  // hand out a heap block that lives until the next reset().
+  enum class Overflow { Throw, Heap };
+
+  explicit LinearArena(std::size_t capacity, Overflow overflow = Overflow::Throw);
+  ~LinearArena();
+  void* allocate(std::size_t num_bytes, std::size_t alignment = alignof(std::max_align_t));
+  template <typename T>
+  T* allocate(std::size_t count) {
+    return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+  }
+  void reset();
+  std::size_t used() const { return m_offset; }
+  std::size_t capacity() const { return m_capacity; }
+private:
+  LinearArena(const LinearArena&) = delete;
+  LinearArena& operator=(const LinearArena&) = delete;
+  unsigned char* m_buffer;
+  std::size_t m_capacity;
+  std::size_t m_offset;
+  Overflow m_overflow;
+  std::vector<unsigned char*> m_heap_blocks;
+};
+
+// Reset once per frame by the render loop; one instance per thread.
+LinearArena& frameArena();
+// Reset by loaders once their temporaries are no longer needed; one instance per thread.
+// Spills to the heap rather than failing on unusually large inputs.
+LinearArena& scratchArena();
+
+// std-compatible allocator so standard containers can live in an arena.
+template <typename T>
+struct ArenaAllocator {
+  using value_type = T;
+  LinearArena* m_arena;
+
+  ArenaAllocator(LinearArena& arena) : m_arena(&arena) {}
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>& other) : m_arena(other.m_arena) {}
+
+  T* allocate(std::size_t count) { return m_arena->allocate<T>(count); }
+  void deallocate(T*, std::size_t) {}
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+  return a.m_arena == b.m_arena;
+}
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+  return !(a == b);
+}
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "glitter.hpp"
+#include "ShaderProgram.hpp"
+
+// A fountain of point sprites. create() picks the compute shader path on a
+// GL 4.3+ context and the CPU path otherwise. Both simulate and spawn the same
+// particles; at capacity the compute path can't reuse slots freed this frame,
+// so it may emit fewer, but neither path ever drops a survivor.
+class ParticleSystem {
+public:
+  // Matches the std430 layout of Particle in particles.comp.
+  struct Particle {
+    glm::vec2 position;
+    glm::vec2 velocity;
+    float life;
+    float max_life;
+  };
+  static std::unique_ptr<ParticleSystem> create(GLsizei max_particles,
+      std::shared_ptr<ShaderProgram> program, bool allow_compute = true);
+  virtual ~ParticleSystem();
+  // Queues `count` new particles at `emitter` for the next update().
+  void emit(GLuint count, const glm::vec2& emitter);
+  virtual void update(float dt) = 0;
+  virtual void draw() const = 0;
+  virtual const char* name() const = 0;
+protected:
+  ParticleSystem(GLsizei max_particles, std::shared_ptr<ShaderProgram> program);
+  GLuint createParticleBuffer(const Particle* data) const;
+  void bindAttributes(GLuint vbo) const;
+  const GLsizei m_max_particles;
+  std::shared_ptr<ShaderProgram> m_program;
+  GLuint m_pending;
+  GLuint m_seed;
+  glm::vec2 m_emitter;
+  const glm::vec2 m_gravity;
+};
+
+// Simulates and compacts on the CPU, then streams positions to one VBO.
+class CpuParticleSystem : public ParticleSystem {
+public:
+  CpuParticleSystem(GLsizei max_particles, std::shared_ptr<ShaderProgram> program);
+  ~CpuParticleSystem();
+  virtual void update(float dt);
+  virtual void draw() const;
+  virtual const char* name() const { return "cpu"; }
+private:
+  std::vector<Particle> m_particles;
+  GLuint m_vao;
+  GLuint m_vbo;
+};
+
+// Keeps particles in ping-ponged SSBOs; the compute pass writes the next
+// frame's live count straight into the indirect draw command.
+class ComputeParticleSystem : public ParticleSystem {
+public:
+  ComputeParticleSystem(GLsizei max_particles, std::shared_ptr<ShaderProgram> program);
+  ~ComputeParticleSystem();
+  virtual void update(float dt);
+  virtual void draw() const;
+  virtual const char* name() const { return "compute"; }
+private:
+  ShaderProgram m_simulate;
+  GLint m_delta_time_uniform;
+  GLint m_emit_count_uniform;
+  GLint m_seed_uniform;
+  GLint m_max_particles_uniform;
+  GLint m_emitter_uniform;
+  GLint m_gravity_uniform;
+  GLuint m_vaos[2];
+  GLuint m_particles[2];
+  GLuint m_commands[2];
+  int m_current; // index of the buffers holding the latest simulation
+};
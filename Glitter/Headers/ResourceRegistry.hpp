@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include <glad/glad.h>
+
+enum class ResourceCategory {
+  VertexBuffer,
+  IndexBuffer,
+  Texture,
+  OtherBuffer, // indirect commands, storage and readback buffers
+  CpuGeometry, // CPU-side copies kept around after upload
+  Count
+};
+
+const char* categoryName(ResourceCategory category);
+
+// Bytes used by a 2D texture, including its mip chain when mipmapped.
+std::size_t textureBytes(GLsizei width, GLsizei height, std::size_t bytes_per_pixel, bool mipmapped);
+
+struct ResourceInfo {
+  std::uintptr_t handle; // GL object name, or address for CPU copies
+  std::size_t bytes;
+  ResourceCategory category;
+  std::string owner;
+};
+
+struct ResourceSnapshot {
+  std::size_t bytes[static_cast<int>(ResourceCategory::Count)];
+  std::size_t counts[static_cast<int>(ResourceCategory::Count)];
+  std::vector<ResourceInfo> resources;
+};
+
+// Records every GL buffer/texture (and retained CPU copy) the engine creates
+// so we can see where memory goes and catch leaks.
+class ResourceRegistry {
+public:
+  ResourceRegistry();
+  void track(std::uintptr_t handle, std::size_t bytes, ResourceCategory category, const std::string& owner);
+  void release(std::uintptr_t handle, ResourceCategory category);
+  ResourceSnapshot snapshot() const;
+  std::size_t bytes(ResourceCategory category) const;
+  // Warns on stderr when a category grows past its budget; 0 disables.
+  void setBudget(ResourceCategory category, std::size_t bytes);
+  // When false, loaders free their CPU-side copies once the GPU has them.
+  void setRetainCpuCopies(bool retain);
+  bool retainCpuCopies() const;
+  // Dumps the per-category totals every `frames` calls to tick(); 0 disables.
+  void setDumpInterval(unsigned frames);
+  void tick();
+  void dump(FILE* out) const;
+private:
+  typedef std::pair<ResourceCategory, std::uintptr_t> Key;
+  mutable std::mutex m_mutex;
+  std::map<Key, ResourceInfo> m_resources;
+  std::size_t m_bytes[static_cast<int>(ResourceCategory::Count)];
+  std::size_t m_counts[static_cast<int>(ResourceCategory::Count)];
+  std::size_t m_budgets[static_cast<int>(ResourceCategory::Count)];
+  bool m_retain_cpu_copies;
+  unsigned m_dump_interval;
+  unsigned m_frames_since_dump;
+};
+
+ResourceRegistry& resourceRegistry();
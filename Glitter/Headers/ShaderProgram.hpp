@@ -1,15 +1,24 @@
+#pragma once
+
 #include <string>
-#include <unordered_map>
+#include <utility>
+#include <vector>
 class ShaderProgram {
 public:
   ShaderProgram(const std::string& vertex_shader_fname, const std::string& fragment_shader_fname);
+  // compute-only program; needs a GL 4.3 context.
+  explicit ShaderProgram(const std::string& compute_shader_fname);
   GLuint getProgram() const;
   GLint getAttribute(const std::string& name);
+  GLint getAttribute(const char* name);
   GLint getUniform(const std::string& name);
+  GLint getUniform(const char* name);
   void debug();
 private:
-  std::unordered_map<std::string, const GLint> m_attributes;
-  std::unordered_map<std::string, const GLint> m_uniforms;
+  // Sorted by name so lookups from string literals don't build a std::string.
+  typedef std::vector<std::pair<std::string, GLint>> LocationTable;
+  LocationTable m_attributes;
+  LocationTable m_uniforms;
   GLuint m_program;
   void readAttributes();
   void readUniforms();
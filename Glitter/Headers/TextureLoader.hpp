@@ -5,6 +5,9 @@ class TextureLoader {
   GLuint m_texture;
 public:
   TextureLoader(const std::string& fname);
+  ~TextureLoader();
+  TextureLoader(const TextureLoader&) = delete;
+  TextureLoader& operator=(const TextureLoader&) = delete;
   GLuint getTexture() const;
   struct TextureGuard {
     TextureGuard(GLuint texture) { glBindTexture(GL_TEXTURE_2D, texture); };
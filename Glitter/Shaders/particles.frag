@@ -0,0 +1,9 @@
+#version 150
+
+in float vFade;
+
+out vec4 frag_color;
+
+void main() {
+  frag_color = vec4(vec3(1.0, 0.5 + 0.5 * vFade, 0.2) * vFade, 1.0);
+}
@@ -0,0 +1,16 @@
+#version 150
+
+in vec2 aPosition;
+in vec2 aLife; // remaining, max
+
+uniform mat4 uModelMatrix;
+uniform mat4 uViewMatrix;
+uniform mat4 uProjMatrix;
+
+out float vFade;
+
+void main () {
+  gl_Position = uProjMatrix * uViewMatrix * uModelMatrix * vec4(aPosition, 0.0, 1.0);
+  gl_PointSize = 2.0;
+  vFade = aLife.x / aLife.y;
+}
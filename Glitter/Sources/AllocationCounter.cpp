@@ -0,0 +1,54 @@
+#include <cstdlib>
+#include <new>
+#include "AllocationCounter.hpp"
+
+#ifdef GLITTER_COUNT_ALLOCATIONS
+
+// Per thread, so driver and windowing worker threads don't show up in the
+// render thread's count.
+static thread_local std::size_t allocation_count = 0;
+
+static void* countedAlloc(std::size_t num_bytes) {
+  ++allocation_count;
+  // malloc(0) may return nullptr, but operator new must not.
+  return std::malloc(num_bytes == 0 ? 1 : num_bytes);
+}
+
+void* operator new(std::size_t num_bytes) {
+  void* p = countedAlloc(num_bytes);
+  if (p == nullptr) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void* operator new[](std::size_t num_bytes) {
+  return operator new(num_bytes);
+}
+
+void* operator new(std::size_t num_bytes, const std::nothrow_t&) noexcept {
+  return countedAlloc(num_bytes);
+}
+
+void* operator new[](std::size_t num_bytes, const std::nothrow_t&) noexcept {
+  return countedAlloc(num_bytes);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+
+std::size_t allocationCount() {
+  return allocation_count;
+}
+
+#else
+
+std::size_t allocationCount() {
+  return 0;
+}
+
+#endif
@@ -0,0 +1,54 @@
+#include <cstdint>
+#include "LinearArena.hpp"
+
+// Sized for a frame's worth of uniform names and draw lists.
+static const std::size_t frame_arena_bytes = 1 << 20;
+// Sized for a typical submesh we convert out of Assimp at load time.
+static const std::size_t scratch_arena_bytes = 64 << 20;
+
+LinearArena::LinearArena(std::size_t capacity, Overflow overflow) :
+    m_buffer(new unsigned char[capacity]), m_capacity(capacity),
+    m_offset(0), m_overflow(overflow) {
+}
+
+LinearArena::~LinearArena() {
+  reset();
+  delete[] m_buffer;
+}
+
+void* LinearArena::allocate(std::size_t num_bytes, std::size_t alignment) {
+  const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(m_buffer);
+  const std::uintptr_t aligned = (base + m_offset + alignment - 1) & ~(alignment - 1);
+  const std::size_t offset = aligned - base;
+  if (offset + num_bytes > m_capacity) {
+    // Falling back to the heap would hide a per-frame overflow, so only
+    // arenas that opted in get one.
+    if (m_overflow == Overflow::Throw) {
+      throw std::bad_alloc();
+    }
+    unsigned char* block = new unsigned char[num_bytes + alignment];
+    m_heap_blocks.push_back(block);
+    const std::uintptr_t start = reinterpret_cast<std::uintptr_t>(block);
+    return block + (((start + alignment - 1) & ~(alignment - 1)) - start);
+  }
+  m_offset = offset + num_bytes;
+  return m_buffer + offset;
+}
+
+void LinearArena::reset() {
+  for (unsigned char* block : m_heap_blocks) {
+    delete[] block;
+  }
+  m_heap_blocks.clear();
+  m_offset = 0;
+}
+
+LinearArena& frameArena() {
+  static thread_local LinearArena arena(frame_arena_bytes);
+  return arena;
+}
+
+LinearArena& scratchArena() {
+  static thread_local LinearArena arena(scratch_arena_bytes, LinearArena::Overflow::Heap);
+  return arena;
+}
@@ -0,0 +1,209 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include "ParticleSystem.hpp"
+#include "ResourceRegistry.hpp"
+
+// Must match hash() in particles.comp so both paths spawn alike.
+static GLuint hash(GLuint x) {
+  x ^= x >> 16;
+  x *= 0x7feb352du;
+  x ^= x >> 15;
+  x *= 0x846ca68bu;
+  x ^= x >> 16;
+  return x;
+}
+
+static float rand01(GLuint x) {
+  return static_cast<float>(hash(x) >> 8) / 16777216.0f;
+}
+
+// The `index`th particle emitted during the update seeded with `seed`.
+static ParticleSystem::Particle spawn(GLuint seed, GLuint index, const glm::vec2& emitter) {
+  const GLuint key = hash(seed) ^ index * 3u;
+  const float angle = 6.2831853f * rand01(key);
+  const float speed = 0.2f + 0.6f * rand01(key + 1u);
+  ParticleSystem::Particle p;
+  p.position = emitter;
+  p.velocity = glm::vec2(std::cos(angle) * speed, std::sin(angle) * speed + 0.5f);
+  p.life = p.max_life = 1.0f + 2.0f * rand01(key + 2u);
+  return p;
+}
+
+std::unique_ptr<ParticleSystem> ParticleSystem::create(GLsizei max_particles,
+    std::shared_ptr<ShaderProgram> program, bool allow_compute) {
+  if (allow_compute && GLAD_GL_VERSION_4_3) {
+    return std::unique_ptr<ParticleSystem>(new ComputeParticleSystem(max_particles, program));
+  }
+  return std::unique_ptr<ParticleSystem>(new CpuParticleSystem(max_particles, program));
+}
+
+ParticleSystem::ParticleSystem(GLsizei max_particles, std::shared_ptr<ShaderProgram> program) :
+    m_max_particles(max_particles), m_program(program), m_pending(0), m_seed(0),
+    m_emitter(0.0f, 0.0f), m_gravity(0.0f, -0.98f) {
+  // let particles.vert size the sprites.
+  glEnable(GL_PROGRAM_POINT_SIZE);
+}
+
+ParticleSystem::~ParticleSystem() {
+}
+
+void ParticleSystem::emit(GLuint count, const glm::vec2& emitter) {
+  m_pending = std::min(m_pending + count, static_cast<GLuint>(m_max_particles));
+  m_emitter = emitter;
+}
+
+GLuint ParticleSystem::createParticleBuffer(const Particle* data) const {
+  const GLsizeiptr num_bytes = m_max_particles * sizeof(Particle);
+  GLuint vbo;
+  glGenBuffers(1, &vbo);
+  glBindBuffer(GL_ARRAY_BUFFER, vbo);
+  glBufferData(GL_ARRAY_BUFFER, num_bytes, data, GL_DYNAMIC_DRAW);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  resourceRegistry().track(vbo, num_bytes, ResourceCategory::VertexBuffer, "ParticleSystem");
+  return vbo;
+}
+
+// Expects the target VAO to be bound.
+void ParticleSystem::bindAttributes(GLuint vbo) const {
+  const GLint position = m_program->getAttribute("aPosition");
+  const GLint life = m_program->getAttribute("aLife");
+  glBindBuffer(GL_ARRAY_BUFFER, vbo);
+  glVertexAttribPointer(position, 2, GL_FLOAT, GL_FALSE, sizeof(Particle),
+    reinterpret_cast<const GLvoid*>(offsetof(Particle, position)));
+  glVertexAttribPointer(life, 2, GL_FLOAT, GL_FALSE, sizeof(Particle),
+    reinterpret_cast<const GLvoid*>(offsetof(Particle, life)));
+  glEnableVertexAttribArray(position);
+  glEnableVertexAttribArray(life);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+CpuParticleSystem::CpuParticleSystem(GLsizei max_particles, std::shared_ptr<ShaderProgram> program) :
+    ParticleSystem(max_particles, program) {
+  // reserve up front so update() never reallocates.
+  m_particles.reserve(m_max_particles);
+  m_vbo = createParticleBuffer(nullptr);
+  glGenVertexArrays(1, &m_vao);
+  glBindVertexArray(m_vao);
+  bindAttributes(m_vbo);
+  glBindVertexArray(0);
+}
+
+CpuParticleSystem::~CpuParticleSystem() {
+  resourceRegistry().release(m_vbo, ResourceCategory::VertexBuffer);
+  glDeleteBuffers(1, &m_vbo);
+  glDeleteVertexArrays(1, &m_vao);
+}
+
+void CpuParticleSystem::update(float dt) {
+  // simulate and compact survivors to the front in one pass.
+  std::size_t alive = 0;
+  for (Particle& p : m_particles) {
+    p.life -= dt;
+    if (p.life <= 0.0f) {
+      continue;
+    }
+    p.velocity += m_gravity * dt;
+    p.position += p.velocity * dt;
+    m_particles[alive++] = p;
+  }
+  m_particles.resize(alive);
+
+  const GLuint room = static_cast<GLuint>(m_max_particles - alive);
+  const GLuint emit_count = std::min(m_pending, room);
+  for (GLuint i = 0; i < emit_count; ++i) {
+    m_particles.push_back(spawn(m_seed, i, m_emitter));
+  }
+  m_pending = 0;
+  ++m_seed;
+
+  glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+  glBufferSubData(GL_ARRAY_BUFFER, 0, m_particles.size() * sizeof(Particle), m_particles.data());
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void CpuParticleSystem::draw() const {
+  glUseProgram(m_program->getProgram());
+  glBindVertexArray(m_vao);
+  glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(m_particles.size()));
+  glBindVertexArray(0);
+  glUseProgram(0);
+}
+
+ComputeParticleSystem::ComputeParticleSystem(GLsizei max_particles, std::shared_ptr<ShaderProgram> program) :
+    ParticleSystem(max_particles, program),
+    m_simulate("Glitter/Shaders/particles.comp"),
+    m_delta_time_uniform(m_simulate.getUniform("uDeltaTime")),
+    m_emit_count_uniform(m_simulate.getUniform("uEmitCount")),
+    m_seed_uniform(m_simulate.getUniform("uSeed")),
+    m_max_particles_uniform(m_simulate.getUniform("uMaxParticles")),
+    m_emitter_uniform(m_simulate.getUniform("uEmitter")),
+    m_gravity_uniform(m_simulate.getUniform("uGravity")),
+    m_current(0) {
+  // DrawArraysIndirectCommand { count, instanceCount, first, baseInstance }
+  const GLuint empty_command[4] = { 0, 1, 0, 0 };
+  glGenBuffers(2, m_commands);
+  glGenVertexArrays(2, m_vaos);
+  for (int i = 0; i < 2; ++i) {
+    m_particles[i] = createParticleBuffer(nullptr);
+    glBindVertexArray(m_vaos[i]);
+    bindAttributes(m_particles[i]);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commands[i]);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, sizeof empty_command, empty_command, GL_DYNAMIC_DRAW);
+    resourceRegistry().track(m_commands[i], sizeof empty_command, ResourceCategory::OtherBuffer, "ParticleSystem");
+  }
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+  glBindVertexArray(0);
+}
+
+ComputeParticleSystem::~ComputeParticleSystem() {
+  for (int i = 0; i < 2; ++i) {
+    resourceRegistry().release(m_particles[i], ResourceCategory::VertexBuffer);
+    resourceRegistry().release(m_commands[i], ResourceCategory::OtherBuffer);
+  }
+  glDeleteBuffers(2, m_particles);
+  glDeleteBuffers(2, m_commands);
+  glDeleteVertexArrays(2, m_vaos);
+}
+
+void ComputeParticleSystem::update(float dt) {
+  const int next = 1 - m_current;
+  const GLuint zero = 0;
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commands[next]);
+  glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, sizeof zero, &zero);
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+  glUseProgram(m_simulate.getProgram());
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_particles[m_current]);
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, m_particles[next]);
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, m_commands[m_current]);
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, m_commands[next]);
+  glUniform1f(m_delta_time_uniform, dt);
+  glUniform1ui(m_emit_count_uniform, m_pending);
+  glUniform1ui(m_seed_uniform, m_seed);
+  glUniform1ui(m_max_particles_uniform, static_cast<GLuint>(m_max_particles));
+  glUniform2fv(m_emitter_uniform, 1, glm::value_ptr(m_emitter));
+  glUniform2fv(m_gravity_uniform, 1, glm::value_ptr(m_gravity));
+
+  // The live count only exists on the GPU, so cover its upper bound rather
+  // than read it back; invocations past it return immediately.
+  const GLuint invocations = static_cast<GLuint>(m_max_particles) + m_pending;
+  glDispatchCompute((invocations + 255) / 256, 1, 1);
+  glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT |
+    GL_COMMAND_BARRIER_BIT);
+  glUseProgram(0);
+
+  m_current = next;
+  m_pending = 0;
+  ++m_seed;
+}
+
+void ComputeParticleSystem::draw() const {
+  glUseProgram(m_program->getProgram());
+  glBindVertexArray(m_vaos[m_current]);
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commands[m_current]);
+  glDrawArraysIndirect(GL_POINTS, nullptr);
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+  glBindVertexArray(0);
+  glUseProgram(0);
+}
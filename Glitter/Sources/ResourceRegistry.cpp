@@ -0,0 +1,136 @@
+#include <algorithm>
+#include "ResourceRegistry.hpp"
+
+static const int num_categories = static_cast<int>(ResourceCategory::Count);
+
+const char* categoryName(ResourceCategory category) {
+  switch (category) {
+    case ResourceCategory::VertexBuffer: return "vertex buffers";
+    case ResourceCategory::IndexBuffer: return "index buffers";
+    case ResourceCategory::Texture: return "textures";
+    case ResourceCategory::OtherBuffer: return "other buffers";
+    case ResourceCategory::CpuGeometry: return "cpu geometry";
+    default: return "unknown";
+  }
+}
+
+std::size_t textureBytes(GLsizei width, GLsizei height, std::size_t bytes_per_pixel, bool mipmapped) {
+  std::size_t total = 0;
+  for (;;) {
+    total += static_cast<std::size_t>(width) * height * bytes_per_pixel;
+    if (!mipmapped || (width == 1 && height == 1)) {
+      return total;
+    }
+    width = std::max(1, width / 2);
+    height = std::max(1, height / 2);
+  }
+}
+
+ResourceRegistry::ResourceRegistry() :
+    m_retain_cpu_copies(true), m_dump_interval(0), m_frames_since_dump(0) {
+  std::fill(m_bytes, m_bytes + num_categories, 0);
+  std::fill(m_counts, m_counts + num_categories, 0);
+  std::fill(m_budgets, m_budgets + num_categories, 0);
+}
+
+void ResourceRegistry::track(std::uintptr_t handle, std::size_t bytes,
+    ResourceCategory category, const std::string& owner) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  const int c = static_cast<int>(category);
+  // Re-tracking a handle (e.g. a buffer re-specified with glBufferData) replaces its size.
+  auto it = m_resources.find(Key(category, handle));
+  if (it != m_resources.end()) {
+    m_bytes[c] -= it->second.bytes;
+    --m_counts[c];
+    m_resources.erase(it);
+  }
+  const std::size_t before = m_bytes[c];
+  m_resources.emplace(Key(category, handle), ResourceInfo{handle, bytes, category, owner});
+  m_bytes[c] += bytes;
+  ++m_counts[c];
+  if (m_budgets[c] != 0 && before <= m_budgets[c] && m_bytes[c] > m_budgets[c]) {
+    fprintf(stderr, "warning: %s over budget: %zu > %zu bytes (last: %s)\n",
+      categoryName(category), m_bytes[c], m_budgets[c], owner.c_str());
+  }
+}
+
+void ResourceRegistry::release(std::uintptr_t handle, ResourceCategory category) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_resources.find(Key(category, handle));
+  if (it == m_resources.end()) {
+    return;
+  }
+  const int c = static_cast<int>(category);
+  m_bytes[c] -= it->second.bytes;
+  --m_counts[c];
+  m_resources.erase(it);
+}
+
+ResourceSnapshot ResourceRegistry::snapshot() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  ResourceSnapshot snapshot;
+  std::copy(m_bytes, m_bytes + num_categories, snapshot.bytes);
+  std::copy(m_counts, m_counts + num_categories, snapshot.counts);
+  snapshot.resources.reserve(m_resources.size());
+  for (auto& it : m_resources) {
+    snapshot.resources.push_back(it.second);
+  }
+  return snapshot;
+}
+
+std::size_t ResourceRegistry::bytes(ResourceCategory category) const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_bytes[static_cast<int>(category)];
+}
+
+void ResourceRegistry::setBudget(ResourceCategory category, std::size_t bytes) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_budgets[static_cast<int>(category)] = bytes;
+}
+
+void ResourceRegistry::setRetainCpuCopies(bool retain) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_retain_cpu_copies = retain;
+}
+
+bool ResourceRegistry::retainCpuCopies() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_retain_cpu_copies;
+}
+
+void ResourceRegistry::setDumpInterval(unsigned frames) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_dump_interval = frames;
+  m_frames_since_dump = 0;
+}
+
+void ResourceRegistry::tick() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_dump_interval == 0 || ++m_frames_since_dump < m_dump_interval) {
+      return;
+    }
+    m_frames_since_dump = 0;
+  }
+  // dump() takes the lock itself.
+  dump(stderr);
+}
+
+// Only uses fprintf so it is safe to call from an allocation-free frame.
+void ResourceRegistry::dump(FILE* out) const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  fprintf(out, "resources:\n");
+  for (int c = 0; c < num_categories; ++c) {
+    fprintf(out, "  %-15s %6zu objects %12zu bytes", categoryName(static_cast<ResourceCategory>(c)),
+      m_counts[c], m_bytes[c]);
+    if (m_budgets[c] != 0) {
+      fprintf(out, " / %zu budget", m_budgets[c]);
+    }
+    fprintf(out, "\n");
+  }
+}
+
+ResourceRegistry& resourceRegistry() {
+  static ResourceRegistry registry;
+  return registry;
+}
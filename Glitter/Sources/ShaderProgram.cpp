@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <sstream>
 #include <iostream> // std::cout, std::endl
@@ -20,10 +22,7 @@ static GLuint compileShader(const GLenum shader_type, const GLchar* shader_src)
   return shader;
 }
 
-static GLuint linkProgram(const GLchar* vertex_shader_src, const GLchar* fragment_shader_src) {
-  const GLuint program = glCreateProgram();
-  glAttachShader(program, compileShader(GL_VERTEX_SHADER, vertex_shader_src));
-  glAttachShader(program, compileShader(GL_FRAGMENT_SHADER, fragment_shader_src));
+static GLuint finishLink(const GLuint program) {
   glLinkProgram(program);
   GLint program_linked;
   glGetProgramiv(program, GL_LINK_STATUS, &program_linked);
@@ -37,6 +36,32 @@ static GLuint linkProgram(const GLchar* vertex_shader_src, const GLchar* fragmen
   return program;
 }
 
+static GLuint linkProgram(const GLchar* vertex_shader_src, const GLchar* fragment_shader_src) {
+  const GLuint program = glCreateProgram();
+  glAttachShader(program, compileShader(GL_VERTEX_SHADER, vertex_shader_src));
+  glAttachShader(program, compileShader(GL_FRAGMENT_SHADER, fragment_shader_src));
+  return finishLink(program);
+}
+
+static GLuint linkProgram(const GLchar* compute_shader_src) {
+  const GLuint program = glCreateProgram();
+  glAttachShader(program, compileShader(GL_COMPUTE_SHADER, compute_shader_src));
+  return finishLink(program);
+}
+
+static bool nameLess(const std::pair<std::string, GLint>& entry, const char* name) {
+  return std::strcmp(entry.first.c_str(), name) < 0;
+}
+
+static GLint findLocation(const std::vector<std::pair<std::string, GLint>>& table,
+    const char* name) {
+  auto it = std::lower_bound(table.begin(), table.end(), name, nameLess);
+  if (it == table.end() || it->first != name) {
+    throw std::out_of_range(name);
+  }
+  return it->second;
+}
+
 // reads a file into a string
 static std::string fname_to_string(const std::string& fname) {
   std::ifstream file(fname, std::ios::in | std::ios::binary);
@@ -63,8 +88,9 @@ void ShaderProgram::readAttributes() {
 
     glGetActiveAttrib(m_program, i, sizeof identifier, nullptr, &size, &type, identifier);
     GLint location = glGetAttribLocation(m_program, identifier);
-    m_attributes.emplace(identifier, location);
+    m_attributes.emplace_back(identifier, location);
   }
+  std::sort(m_attributes.begin(), m_attributes.end());
 }
 
 void ShaderProgram::readUniforms() {
@@ -81,8 +107,9 @@ void ShaderProgram::readUniforms() {
 
     glGetActiveUniform(m_program, i, sizeof identifier, nullptr, &size, &type, identifier);
     GLint location = glGetUniformLocation(m_program, identifier);
-    m_uniforms.emplace(identifier, location);
+    m_uniforms.emplace_back(identifier, location);
   }
+  std::sort(m_uniforms.begin(), m_uniforms.end());
 }
 
 ShaderProgram::ShaderProgram(const std::string& vertex_shader_fname, const std::string& fragment_shader_fname) {
@@ -92,16 +119,30 @@ ShaderProgram::ShaderProgram(const std::string& vertex_shader_fname, const std::
   readUniforms();
 }
 
+ShaderProgram::ShaderProgram(const std::string& compute_shader_fname) {
+  m_program = linkProgram(fname_to_string(compute_shader_fname).c_str());
+  readAttributes();
+  readUniforms();
+}
+
 GLuint ShaderProgram::getProgram() const {
   return m_program;
 }
 
 GLint ShaderProgram::getAttribute(const std::string& name) {
- return m_attributes.at(name);
+  return getAttribute(name.c_str());
+}
+
+GLint ShaderProgram::getAttribute(const char* name) {
+  return findLocation(m_attributes, name);
 }
 
 GLint ShaderProgram::getUniform(const std::string & name) {
-  return m_uniforms.at(name);
+  return getUniform(name.c_str());
+}
+
+GLint ShaderProgram::getUniform(const char* name) {
+  return findLocation(m_uniforms, name);
 }
 
 void ShaderProgram::debug() {
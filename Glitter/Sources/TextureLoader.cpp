@@ -1,4 +1,5 @@
 #include "TextureLoader.hpp"
+#include "ResourceRegistry.hpp"
 
 #include <iostream>
 // TODO: we can cut this down to only support .jpg for instance
@@ -24,9 +25,17 @@ TextureLoader::TextureLoader(const std::string & fname) {
   // that this should be         GL_RGBA8                  GL_BGRA but that does not work.
   glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
   glGenerateMipmap(GL_TEXTURE_2D);
+  // drivers pad GL_RGB out to 4 bytes per texel.
+  resourceRegistry().track(m_texture, textureBytes(width, height, 4, true),
+    ResourceCategory::Texture, fname);
   stbi_image_free(data);
 }
 
+TextureLoader::~TextureLoader() {
+  resourceRegistry().release(m_texture, ResourceCategory::Texture);
+  glDeleteTextures(1, &m_texture);
+}
+
 GLuint TextureLoader::getTexture() const {
   return m_texture;
 }
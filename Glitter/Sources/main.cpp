@@ -6,13 +6,19 @@
 #include <GLFW/glfw3.h>
 
 // Standard Headers
+#include <cassert>
 #include <cstdio>
 #include <cstdlib>
 #include <iostream>
 #include <memory>
+#include <string>
 #include <vector>
 #include <glm/gtc/matrix_transform.hpp>
 
+#include "AllocationCounter.hpp"
+#include "LinearArena.hpp"
+#include "ParticleSystem.hpp"
+#include "ResourceRegistry.hpp"
 #include "ShaderProgram.hpp"
 #include "TextureLoader.hpp"
 
@@ -35,6 +41,7 @@ struct Shape {
   std::vector<glm::vec2> m_vertices;
   GLuint m_vao;
   GLuint m_vertices_vbo;
+  std::vector<GLuint> m_vbos; // every buffer we own, for cleanup
   std::shared_ptr<ShaderProgram> m_program;
   Shape(std::vector<glm::vec2> vertices, std::shared_ptr<ShaderProgram> program) :
       m_vertices(std::move(vertices)), m_program(program) {
@@ -46,8 +53,15 @@ struct Shape {
 
     //print_vertices();
   }
+  virtual ~Shape() {
+    for (GLuint vbo : m_vbos) {
+      resourceRegistry().release(vbo, ResourceCategory::VertexBuffer);
+    }
+    glDeleteBuffers(static_cast<GLsizei>(m_vbos.size()), m_vbos.data());
+    glDeleteVertexArrays(1, &m_vao);
+  }
   template <typename T>
-  GLuint bufferStaticData(const std::vector<T>& data, const GLint attribute) const {
+  GLuint bufferStaticData(const std::vector<T>& data, const GLint attribute) {
     const GLsizeiptr num_bytes = data.size() * sizeof(T);
     constexpr GLint elem_per_vertex = sizeof(T) / sizeof(float);
     GLuint vbo;
@@ -56,6 +70,8 @@ struct Shape {
     glBufferData(GL_ARRAY_BUFFER, num_bytes, &data[0], GL_STATIC_DRAW);
     glVertexAttribPointer(attribute, elem_per_vertex, GL_FLOAT, GL_FALSE, 0, nullptr);
     glEnableVertexAttribArray(attribute);
+    resourceRegistry().track(vbo, num_bytes, ResourceCategory::VertexBuffer, "Shape");
+    m_vbos.push_back(vbo);
     return vbo;
   }
   virtual void draw() const = 0;
@@ -161,6 +177,46 @@ void setup(std::vector<Shape*>& shapes) {
   setUniforms(textured_program);
 }
 
+std::unique_ptr<ParticleSystem> setup_particles(GLsizei max_particles, bool allow_compute = true) {
+  auto particle_program = std::make_shared<ShaderProgram>(
+    "Glitter/Shaders/particles.vert",
+    "Glitter/Shaders/particles.frag");
+  setUniforms(particle_program);
+  return ParticleSystem::create(max_particles, particle_program, allow_compute);
+}
+
+// Times update + draw of a million sprites on each available path.
+void benchmark_particles(GLFWwindow* const window) {
+  const GLsizei max_particles = 1 << 20;
+  const int frames = 300;
+  // vsync would pin both paths to the refresh rate.
+  glfwSwapInterval(0);
+  for (bool allow_compute : { true, false }) {
+    if (allow_compute && !GLAD_GL_VERSION_4_3) {
+      fprintf(stderr, "compute: unavailable (needs OpenGL 4.3)\n");
+      continue;
+    }
+    auto particles = setup_particles(max_particles, allow_compute);
+    // fill up before timing so both paths run at capacity.
+    for (int i = 0; i < 180; ++i) {
+      particles->emit(max_particles / 60, glm::vec2(0.0f, -0.5f));
+      particles->update(1.0f / 60.0f);
+    }
+    glFinish();
+    const double start = glfwGetTime();
+    for (int i = 0; i < frames; ++i) {
+      particles->emit(max_particles / 60, glm::vec2(0.0f, -0.5f));
+      particles->update(1.0f / 60.0f);
+      glClear(GL_COLOR_BUFFER_BIT);
+      particles->draw();
+      glfwSwapBuffers(window);
+    }
+    glFinish();
+    const double elapsed = glfwGetTime() - start;
+    fprintf(stderr, "%s: %.3f ms/frame\n", particles->name(), 1000.0 * elapsed / frames);
+  }
+}
+
 void handle_input(GLFWwindow* const window, std::vector<Shape*>& shapes) {
   if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS) {
     glfwSetWindowShouldClose(window, true);
@@ -181,12 +237,18 @@ int main(int argc, char * argv[]) {
   // Load GLFW and Create a Window
   glfwInit();
   glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-  glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 0);
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
   glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
   glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
   glfwWindowHint(GLFW_RESIZABLE, GL_FALSE);
   auto mWindow = glfwCreateWindow(mWidth, mHeight, "My first game", nullptr, nullptr);
 
+  // 4.3 gets us compute shaders; otherwise (e.g. macOS) settle for 4.0.
+  if (mWindow == nullptr) {
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 0);
+    mWindow = glfwCreateWindow(mWidth, mHeight, "My first game", nullptr, nullptr);
+  }
+
   // Check for Valid Context
   if (mWindow == nullptr) {
     fprintf(stderr, "Failed to Create OpenGL Context");
@@ -198,11 +260,30 @@ int main(int argc, char * argv[]) {
   gladLoadGL();
   fprintf(stderr, "OpenGL %s\n", glGetString(GL_VERSION));
 
+  if (argc > 1 && std::string(argv[1]) == "--bench-particles") {
+    benchmark_particles(mWindow);
+    glfwTerminate();
+    return EXIT_SUCCESS;
+  }
+
   std::vector<Shape*> shapes;
   setup(shapes);
+  auto particles = setup_particles(1 << 16);
+  fprintf(stderr, "particles: %s\n", particles->name());
+  scratchArena().reset();
+
+  // Write resource totals to stderr every ~10 seconds at 60Hz.
+  resourceRegistry().setDumpInterval(600);
+  resourceRegistry().dump(stderr);
+
+  // Frames before this one may still be warming up lazily-allocated state.
+  const unsigned long warmup_frames = 2;
+  double last_time = glfwGetTime();
+  unsigned long frame = 0;
 
   // Rendering Loop
   while (glfwWindowShouldClose(mWindow) == false) {
+    const std::size_t allocations_before = allocationCount();
     handle_input(mWindow, shapes);
 
     // Background Fill Color
@@ -213,9 +294,31 @@ int main(int argc, char * argv[]) {
       shape->draw();
     }
 
+    const double now = glfwGetTime();
+    particles->emit(256, glm::vec2(0.0f, -0.5f));
+    particles->update(static_cast<float>(now - last_time));
+    particles->draw();
+    last_time = now;
+
     // Flip Buffers and Draw
     glfwSwapBuffers(mWindow);
-    glfwWaitEvents();
+    // particles animate, so poll rather than sleep until the next input.
+    glfwPollEvents();
+    frameArena().reset();
+    resourceRegistry().tick();
+
+#ifdef GLITTER_COUNT_ALLOCATIONS
+    // Counts are per thread, so this covers the render thread only.
+    const std::size_t frame_allocations = allocationCount() - allocations_before;
+    if (frame_allocations != 0) {
+      fprintf(stderr, "frame %lu: %zu heap allocations\n", frame, frame_allocations);
+    }
+    assert(frame < warmup_frames || frame_allocations == 0);
+#else
+    (void)allocations_before;
+    (void)warmup_frames;
+#endif
+    ++frame;
   }
 
   glfwTerminate();
@@ -0,0 +1,387 @@
+// Local Headers
+#include "gltf.hpp"
+
+// System Headers
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Standard Headers
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+// Define Namespace
+namespace Mirage
+{
+    MappedFile::MappedFile(std::string const & filename)
+        : mData(nullptr), mSize(0), mHandle(nullptr)
+    {
+#ifdef _WIN32
+        HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                                  nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) throw std::runtime_error("unable to open " + filename);
+        LARGE_INTEGER size; GetFileSizeEx(file, & size);
+        mSize   = static_cast<std::size_t>(size.QuadPart);
+        mHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (!mHandle) throw std::runtime_error("unable to map " + filename);
+        mData = static_cast<unsigned char const *>(MapViewOfFile(mHandle, FILE_MAP_READ, 0, 0, 0));
+        if (!mData) CloseHandle(mHandle); // The Destructor Won't Run After a Throw
+#else
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("unable to open " + filename);
+        struct stat info;
+        if (fstat(fd, & info) != 0)
+        {   close(fd);
+            throw std::runtime_error("unable to stat " + filename);
+        }
+        mSize = static_cast<std::size_t>(info.st_size);
+        void * data = mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd); // The Mapping Keeps its Own Reference
+        if (data != MAP_FAILED) mData = static_cast<unsigned char const *>(data);
+#endif
+        if (!mData) throw std::runtime_error("unable to map " + filename);
+    }
+
+    MappedFile::~MappedFile()
+    {
+#ifdef _WIN32
+        UnmapViewOfFile(mData);
+        CloseHandle(mHandle);
+#else
+        munmap(const_cast<unsigned char *>(mData), mSize);
+#endif
+    }
+
+    // Just Enough JSON to Read a glTF Header; Numbers are Kept as Doubles
+    namespace
+    {
+        struct Json
+        {
+            enum Type { Null, Boolean, Number, String, Array, Object } type = Null;
+            double number = 0.0;
+            std::string string;
+            std::vector<Json> array;
+            std::vector<std::pair<std::string, Json>> object;
+
+            Json const * find(char const * key) const
+            {
+                for (auto &i : object) if (i.first == key) return & i.second;
+                return nullptr;
+            }
+        };
+
+        class JsonParser
+        {
+        public:
+            JsonParser(char const * begin, char const * end) : mCursor(begin), mEnd(end) {}
+
+            Json parse()
+            {
+                Json value;
+                skip();
+                if (mCursor == mEnd) fail();
+                switch (*mCursor)
+                {
+                    case '{' : value.type = Json::Object; parseObject(value);  break;
+                    case '[' : value.type = Json::Array;  parseArray(value);   break;
+                    case '"' : value.type = Json::String; value.string = parseString(); break;
+                    case 't' : value.type = Json::Boolean; value.number = 1; literal("true"); break;
+                    case 'f' : value.type = Json::Boolean; literal("false"); break;
+                    case 'n' : literal("null"); break;
+                    default  : value.type = Json::Number; value.number = parseNumber(); break;
+                }   return value;
+            }
+
+        private:
+
+            void fail() { throw std::runtime_error("malformed glTF JSON"); }
+            void skip() { while (mCursor != mEnd && std::strchr(" \t\r\n", *mCursor) && *mCursor) mCursor++; }
+            void expect(char c) { skip(); if (mCursor == mEnd || *mCursor != c) fail(); mCursor++; }
+
+            bool separator()
+            {
+                skip();
+                if (mCursor == mEnd || *mCursor != ',') return false;
+                mCursor++; return true;
+            }
+
+            void literal(char const * word)
+            {
+                std::size_t length = std::strlen(word);
+                if (static_cast<std::size_t>(mEnd - mCursor) < length
+                    || std::strncmp(mCursor, word, length) != 0) fail();
+                mCursor += length;
+            }
+
+            void parseObject(Json & value)
+            {
+                expect('{'); skip();
+                if (mCursor != mEnd && *mCursor == '}') { mCursor++; return; }
+                do
+                {   skip(); std::string key = parseString();
+                    expect(':');
+                    value.object.emplace_back(std::move(key), parse());
+                } while (separator());
+                expect('}');
+            }
+
+            void parseArray(Json & value)
+            {
+                expect('['); skip();
+                if (mCursor != mEnd && *mCursor == ']') { mCursor++; return; }
+                do value.array.push_back(parse());
+                while (separator());
+                expect(']');
+            }
+
+            // Decodes Every JSON Escape; \uXXXX (and Surrogate Pairs) Become UTF-8
+            std::string parseString()
+            {
+                expect('"');
+                std::string result;
+                while (mCursor != mEnd && *mCursor != '"')
+                {   if (*mCursor != '\\') { result += *mCursor++; continue; }
+                    if (++mCursor == mEnd) fail();
+                    switch (*mCursor++)
+                    {
+                        case '"'  : result += '"';  break;
+                        case '\\' : result += '\\'; break;
+                        case '/'  : result += '/';  break;
+                        case 'b'  : result += '\b'; break;
+                        case 'f'  : result += '\f'; break;
+                        case 'n'  : result += '\n'; break;
+                        case 'r'  : result += '\r'; break;
+                        case 't'  : result += '\t'; break;
+                        case 'u'  : utf8(result, codepoint()); break;
+                        default   : fail();
+                    }
+                }   expect('"');
+                return result;
+            }
+
+            unsigned long hex()
+            {
+                if (mEnd - mCursor < 4) fail();
+                unsigned long value = 0;
+                for (int i = 0; i < 4; i++, mCursor++)
+                {        if (*mCursor >= '0' && *mCursor <= '9') value = value * 16 + (*mCursor - '0');
+                    else if (*mCursor >= 'a' && *mCursor <= 'f') value = value * 16 + (*mCursor - 'a' + 10);
+                    else if (*mCursor >= 'A' && *mCursor <= 'F') value = value * 16 + (*mCursor - 'A' + 10);
+                    else fail();
+                }   return value;
+            }
+
+            unsigned long codepoint()
+            {
+                // A High Surrogate Must be Followed by an Escaped Low Surrogate
+                unsigned long high = hex();
+                if (high >= 0xDC00 && high <= 0xDFFF) fail();
+                if (high < 0xD800 || high > 0xDBFF) return high;
+                if (mEnd - mCursor < 2 || mCursor[0] != '\\' || mCursor[1] != 'u') fail();
+                mCursor += 2;
+                unsigned long low = hex();
+                if (low < 0xDC00 || low > 0xDFFF) fail();
+                return 0x10000 + ((high - 0xD800) << 10) + (low - 0xDC00);
+            }
+
+            static void utf8(std::string & out, unsigned long c)
+            {
+                     if (c < 0x80)    out += static_cast<char>(c);
+                else if (c < 0x800)   { out += static_cast<char>(0xC0 | c >> 6);
+                                        out += static_cast<char>(0x80 | (c & 0x3F)); }
+                else if (c < 0x10000) { out += static_cast<char>(0xE0 | c >> 12);
+                                        out += static_cast<char>(0x80 | (c >> 6 & 0x3F));
+                                        out += static_cast<char>(0x80 | (c & 0x3F)); }
+                else                  { out += static_cast<char>(0xF0 | c >> 18);
+                                        out += static_cast<char>(0x80 | (c >> 12 & 0x3F));
+                                        out += static_cast<char>(0x80 | (c >> 6 & 0x3F));
+                                        out += static_cast<char>(0x80 | (c & 0x3F)); }
+            }
+
+            double parseNumber()
+            {
+                char buffer[64]; std::size_t length = 0;
+                while (mCursor != mEnd && length < sizeof(buffer) - 1
+                       && std::strchr("+-0123456789.eE", *mCursor) && *mCursor)
+                    buffer[length++] = *mCursor++;
+                if (length == 0) fail();
+                buffer[length] = '\0';
+                return std::strtod(buffer, nullptr);
+            }
+
+            char const * mCursor;
+            char const * mEnd;
+        };
+
+        // Helpers for Optional Integer Fields
+        long integer(Json const & object, char const * key, long fallback)
+        {
+            Json const * value = object.find(key);
+            return value ? static_cast<long>(value->number) : fallback;
+        }
+
+        long integer(Json const & object, char const * key)
+        {
+            Json const * value = object.find(key);
+            if (!value) throw std::runtime_error(std::string("glTF is missing required ") + key);
+            return static_cast<long>(value->number);
+        }
+
+        std::uint32_t little(unsigned char const * bytes)
+        {
+            return  static_cast<std::uint32_t>(bytes[0])        | static_cast<std::uint32_t>(bytes[1]) << 8
+                  | static_cast<std::uint32_t>(bytes[2]) << 16  | static_cast<std::uint32_t>(bytes[3]) << 24;
+        }
+
+        GLint components(std::string const & type)
+        {
+                 if (type == "SCALAR") return 1;
+            else if (type == "VEC2")   return 2;
+            else if (type == "VEC3")   return 3;
+            else if (type == "VEC4")   return 4;
+            throw std::runtime_error("unsupported glTF accessor type " + type);
+        }
+
+        std::size_t componentSize(GLenum type)
+        {
+            switch (type)
+            {
+                case GL_BYTE  : case GL_UNSIGNED_BYTE  : return 1;
+                case GL_SHORT : case GL_UNSIGNED_SHORT : return 2;
+                case GL_UNSIGNED_INT : case GL_FLOAT   : return 4;
+            }   throw std::runtime_error("unsupported glTF component type");
+        }
+    }
+
+    Gltf::Gltf(std::string const & filename)
+        : mFile(filename), mBinary(nullptr), mBinarySize(0)
+    {
+        // Validate the 12-Byte Header: Magic, Version, Total Length
+        unsigned char const * data = mFile.data();
+        std::size_t size = mFile.size();
+        if (size < 20 || std::memcmp(data, "glTF", 4) != 0) throw std::runtime_error("not a binary glTF: " + filename);
+        if (little(data + 4) != 2) throw std::runtime_error("unsupported glTF version: " + filename);
+
+        // Walk Chunks; the First is JSON and the Optional Second is BIN
+        char const * jsonBegin = nullptr, * jsonEnd = nullptr;
+        for (std::size_t offset = 12; offset + 8 <= size;)
+        {
+            std::size_t length = little(data + offset);
+            std::uint32_t type = little(data + offset + 4);
+            if (offset + 8 + length > size) throw std::runtime_error("truncated glTF chunk: " + filename);
+            if (type == 0x4E4F534A && !jsonBegin)
+            {   jsonBegin = reinterpret_cast<char const *>(data + offset + 8);
+                jsonEnd   = jsonBegin + length;
+            }
+            else if (type == 0x004E4942 && !mBinary)
+            {   mBinary     = data + offset + 8;
+                mBinarySize = length;
+            }   offset += 8 + length;
+        }
+        if (!jsonBegin) throw std::runtime_error("glTF has no JSON chunk: " + filename);
+        Json root = JsonParser(jsonBegin, jsonEnd).parse();
+
+        // Buffer Views Must Live in the Embedded BIN Chunk for Zero-Copy Uploads
+        if (Json const * views = root.find("bufferViews"))
+        for (auto &i : views->array)
+        {
+            if (integer(i, "buffer") != 0) throw std::runtime_error("glTF external buffers are unsupported");
+            GltfBufferView view;
+            view.byteOffset = integer(i, "byteOffset", 0);
+            view.byteLength = integer(i, "byteLength");
+            view.byteStride = static_cast<GLsizei>(integer(i, "byteStride", 0));
+            if (view.byteOffset + view.byteLength > mBinarySize) throw std::runtime_error("glTF buffer view out of range");
+            mBufferViews.push_back(view);
+        }
+
+        if (Json const * accessors = root.find("accessors"))
+        for (auto &i : accessors->array)
+        {
+            if (i.find("sparse") || !i.find("bufferView")) throw std::runtime_error("glTF sparse accessors are unsupported");
+            GltfAccessor accessor;
+            accessor.bufferView    = static_cast<int>(integer(i, "bufferView"));
+            accessor.byteOffset    = integer(i, "byteOffset", 0);
+            accessor.componentType = static_cast<GLenum>(integer(i, "componentType"));
+            accessor.count         = static_cast<GLsizei>(integer(i, "count"));
+            accessor.normalized    = integer(i, "normalized", 0) ? GL_TRUE : GL_FALSE;
+            Json const * min = i.find("min"), * max = i.find("max");
+            accessor.bounded       = min && max && min->array.size() >= 3 && max->array.size() >= 3;
+            for (int j = 0; accessor.bounded && j < 3; j++)
+            {   accessor.min[j] = static_cast<float>(min->array[j].number);
+                accessor.max[j] = static_cast<float>(max->array[j].number);
+            }
+            Json const * type = i.find("type");
+            accessor.components    = components(type ? type->string : "");
+            if (accessor.bufferView < 0 || accessor.bufferView >= static_cast<int>(mBufferViews.size()))
+                throw std::runtime_error("glTF accessor references a missing buffer view");
+            GltfBufferView const & view = mBufferViews[accessor.bufferView];
+            std::size_t element = componentSize(accessor.componentType) * accessor.components;
+            std::size_t stride  = view.byteStride ? view.byteStride : element;
+            if (accessor.count > 0 && accessor.byteOffset + stride * (accessor.count - 1) + element > view.byteLength)
+                throw std::runtime_error("glTF accessor out of range");
+            mAccessors.push_back(accessor);
+        }
+
+        // Images are Either Embedded Buffer Views or External Files
+        if (Json const * images = root.find("images"))
+        for (auto &i : images->array)
+        {
+            GltfImage image;
+            image.bufferView = static_cast<int>(integer(i, "bufferView", -1));
+            if (Json const * uri = i.find("uri")) image.uri = uri->string;
+            mImages.push_back(image);
+        }
+
+        // Resolve Material -> Base Color Texture -> Image Once, up Front
+        std::vector<int> materialImages;
+        Json const * textures = root.find("textures");
+        if (Json const * materials = root.find("materials"))
+        for (auto &i : materials->array)
+        {
+            int image = -1;
+            Json const * pbr = i.find("pbrMetallicRoughness");
+            Json const * base = pbr ? pbr->find("baseColorTexture") : nullptr;
+            if (base && textures)
+            {   long texture = integer(*base, "index");
+                if (texture >= 0 && texture < static_cast<long>(textures->array.size()))
+                    image = static_cast<int>(integer(textures->array[texture], "source", -1));
+            }   materialImages.push_back(image);
+        }
+
+        // Flatten Every Triangle Primitive of Every Mesh
+        auto accessor = [this](Json const & object, char const * key)
+        {
+            long index = integer(object, key, -1);
+            if (index >= static_cast<long>(mAccessors.size())) throw std::runtime_error("glTF accessor index out of range");
+            return static_cast<int>(index);
+        };
+        if (Json const * meshes = root.find("meshes"))
+        for (auto &i : meshes->array)
+        if (Json const * primitives = i.find("primitives"))
+        for (auto &j : primitives->array)
+        {
+            if (integer(j, "mode", 4) != 4) throw std::runtime_error("glTF primitive mode is not triangles");
+            Json const * attributes = j.find("attributes");
+            if (!attributes) throw std::runtime_error("glTF primitive has no attributes");
+            GltfPrimitive primitive;
+            primitive.position = accessor(*attributes, "POSITION");
+            primitive.normal   = accessor(*attributes, "NORMAL");
+            primitive.uv       = accessor(*attributes, "TEXCOORD_0");
+            primitive.indices  = accessor(j, "indices");
+            long material      = integer(j, "material", -1);
+            if (material >= 0 && material < static_cast<long>(materialImages.size()))
+                primitive.image = materialImages[material];
+            if (primitive.position < 0) throw std::runtime_error("glTF primitive has no positions");
+            mPrimitives.push_back(primitive);
+        }
+    }
+};
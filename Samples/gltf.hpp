@@ -0,0 +1,99 @@
+#pragma once
+
+// System Headers
+#include <glad/glad.h>
+
+// Standard Headers
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Define Namespace
+namespace Mirage
+{
+    // Read-Only Mapping of an Entire File into Memory
+    class MappedFile
+    {
+    public:
+
+        // Implement Custom Constructor and Destructor
+         MappedFile(std::string const & filename);
+        ~MappedFile();
+
+        // Public Member Functions
+        unsigned char const * data() const { return mData; }
+        std::size_t           size() const { return mSize; }
+
+    private:
+
+        // Disable Copying and Assignment
+        MappedFile(MappedFile const &) = delete;
+        MappedFile & operator=(MappedFile const &) = delete;
+
+        // Private Member Variables
+        unsigned char const * mData;
+        std::size_t mSize;
+        void * mHandle; // Windows Mapping Object
+
+    };
+
+    // The Slice of glTF 2.0 We Need to Draw Triangle Meshes. Component Types
+    // and Buffer Targets are Defined by the Spec as Their OpenGL Enums.
+    struct GltfBufferView {
+        std::size_t byteOffset;
+        std::size_t byteLength;
+        GLsizei     byteStride;
+    };
+
+    struct GltfAccessor {
+        int         bufferView;
+        std::size_t byteOffset;
+        GLenum      componentType;
+        GLint       components;
+        GLsizei     count;
+        GLboolean   normalized;
+        bool        bounded;  // min/max Given, as Required for POSITION
+        float       min[3];
+        float       max[3];
+    };
+
+    struct GltfPrimitive {
+        int position = -1;
+        int normal   = -1;
+        int uv       = -1;
+        int indices  = -1;
+        int image    = -1; // Base Color Image
+    };
+
+    struct GltfImage {
+        int bufferView = -1; // Embedded in the Binary Chunk...
+        std::string uri;     // ...or a Path Relative to the Model
+    };
+
+    // Binary glTF (.glb) Whose Buffer Data Stays in the Mapped File
+    class Gltf
+    {
+    public:
+
+        // Throws std::runtime_error on Malformed or Unsupported Files
+        Gltf(std::string const & filename);
+
+        // Public Member Functions
+        unsigned char const * binary() const { return mBinary; }
+        unsigned char const * view(int index) const { return mBinary + mBufferViews[index].byteOffset; }
+
+        // Public Member Containers
+        std::vector<GltfBufferView> mBufferViews;
+        std::vector<GltfAccessor>   mAccessors;
+        std::vector<GltfPrimitive>  mPrimitives;
+        std::vector<GltfImage>      mImages;
+
+    private:
+
+        // Private Member Variables
+        MappedFile mFile;
+        unsigned char const * mBinary;
+        std::size_t mBinarySize;
+
+    };
+};
@@ -7,31 +7,167 @@
 // System Headers
 #include <stb_image.h>
 
+// Standard Headers
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
 // Define Namespace
 namespace Mirage
 {
-    Mesh::Mesh(std::string const & filename) : Mesh()
+    // Upload Decoded Pixels as a Mipmapped Texture and Record its Size
+    static GLuint texture(unsigned char const * image, int width, int height,
+                          int channels, std::string const & filename)
+    {
+        // Set the Correct Channel Format
+        GLenum format = GL_RGB;
+        switch (channels)
+        {
+            case 1 : format = GL_ALPHA;     break;
+            case 2 : format = GL_LUMINANCE; break;
+            case 3 : format = GL_RGB;       break;
+            case 4 : format = GL_RGBA;      break;
+        }
+
+        // Bind Texture and Set Filtering Levels
+        GLuint texture;
+        glGenTextures(1, & texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexImage2D(GL_TEXTURE_2D, 0, format,
+                     width, height, 0, format, GL_UNSIGNED_BYTE, image);
+        glGenerateMipmap(GL_TEXTURE_2D);
+
+        // Drivers Pad RGB to RGBA
+        resourceRegistry().track(texture,
+            textureBytes(width, height, channels == 3 ? 4 : channels, true),
+            ResourceCategory::Texture, filename);
+        return texture;
+    }
+
+    Mesh::Mesh(std::string const & filename, Loader loader) : Mesh()
     {
+        // Binary glTF Buffers are Already GPU-Ready, so Skip Assimp Entirely
+        auto index = filename.find_last_of("/");
+        bool glb = filename.size() > 4 && filename.compare(filename.size() - 4, 4, ".glb") == 0;
+        mGltf = loader == Loader::Auto && glb && parse(filename.substr(0, index), filename);
+        if (mGltf) return;
+
         // Load a Model from File
-        Assimp::Importer loader;
-        aiScene const * scene = loader.ReadFile(
+        Assimp::Importer importer;
+        aiScene const * scene = importer.ReadFile(
             PROJECT_SOURCE_DIR "/Mirage/Models/" + filename,
             aiProcessPreset_TargetRealtime_MaxQuality |
             aiProcess_OptimizeGraph                   |
             aiProcess_FlipUVs);
 
         // Walk the Tree of Scene Nodes
-        auto index = filename.find_last_of("/");
-        if (!scene) fprintf(stderr, "%s\n", loader.GetErrorString());
+        if (!scene) fprintf(stderr, "%s\n", importer.GetErrorString());
         else parse(filename.substr(0, index), scene->mRootNode, scene);
     }
 
+    void Mesh::benchmark(std::string const & filename)
+    {
+        // glFinish so Asynchronous Uploads Count Towards Each Loader, and Hold
+        // Off on LOD Cooking so Only the Loaders Themselves are Timed
+        using Clock = std::chrono::high_resolution_clock;
+        LodSettings settings = lodSettings();
+        lodSettings().ratios.clear();
+        bool zeroCopy = false;
+        auto measure = [&](Loader loader)
+        {
+            auto start = Clock::now();
+            std::unique_ptr<Mesh> mesh(new Mesh(filename, loader));
+            glFinish();
+            zeroCopy = mesh->mGltf;
+            return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        };
+        double gltf = measure(Loader::Auto);
+        if (!zeroCopy)
+        {   lodSettings() = settings;
+            fprintf(stderr, "%s: Not Loaded as glTF, Nothing to Compare\n", filename.c_str());
+            return;
+        }
+        double assimp = measure(Loader::Assimp);
+        lodSettings() = settings;
+        fprintf(stderr, "%s: glTF %.2f ms, Assimp %.2f ms (%.1fx)\n",
+                filename.c_str(), gltf, assimp, assimp / gltf);
+    }
+
     Mesh::Mesh(std::vector<Vertex> const & vertices,
                std::vector<GLuint> const & indices,
                std::map<GLuint, std::string> const & textures)
-                    : mIndices(indices)
-                    , mVertices(vertices)
-                    , mTextures(textures)
+                    : mTextures(textures)
+    {
+        upload(vertices.data(), vertices.size(), indices.data(), indices.size(), true);
+    }
+
+    Mesh::Mesh(ArenaVector<Vertex> const & vertices,
+               ArenaVector<GLuint> const & indices,
+               std::map<GLuint, std::string> const & textures,
+               bool triangles)
+                    : mTextures(textures)
+    {
+        upload(vertices.data(), vertices.size(), indices.data(), indices.size(), triangles);
+    }
+
+    Mesh::~Mesh()
+    {
+        // Forget Tracked Resources Before Freeing Them
+        auto & registry = resourceRegistry();
+        registry.release(mVertexBuffer,  ResourceCategory::VertexBuffer);
+        registry.release(mElementBuffer, ResourceCategory::IndexBuffer);
+        registry.release(reinterpret_cast<std::uintptr_t>(this), ResourceCategory::CpuGeometry);
+        for (auto &i : mBuffers)
+        {   registry.release(i, ResourceCategory::VertexBuffer);
+            registry.release(i, ResourceCategory::IndexBuffer);
+        }   glDeleteBuffers(static_cast<GLsizei>(mBuffers.size()), mBuffers.data());
+        for (auto &i : mTextures)
+        {   registry.release(i.first, ResourceCategory::Texture);
+            glDeleteTextures(1, & i.first);
+        }   glDeleteBuffers(1, & mVertexBuffer);
+            glDeleteBuffers(1, & mElementBuffer);
+            glDeleteVertexArrays(1, & mVertexArray);
+    }
+
+    // Lines, Points, Small Sub-Meshes, and Disabled Cooking Keep One Level
+    static bool cookable(std::size_t indexCount, bool triangles)
+    {
+        LodSettings const & settings = lodSettings();
+        return triangles && !settings.ratios.empty()
+            && indexCount % 3 == 0 && indexCount >= settings.minimum;
+    }
+
+    std::vector<GLuint> Mesh::cook(float const * positions, std::size_t stride, std::size_t vertexCount,
+                                   std::vector<GLuint> levels, bool triangles)
+    {
+        // Full Detail Comes in as levels; Coarser Levels are Appended to it
+        std::size_t indexCount = levels.size();
+        mLods.assign(1, Lod{ 0, static_cast<GLsizei>(indexCount), 0.0f });
+        if (!cookable(indexCount, triangles)) return levels;
+        LodSettings const & settings = lodSettings();
+        GLuint const * indices = levels.data();
+
+        // Cook Coarser Index Lists over the Same Vertices, Stopping Once
+        // Simplification Stalls (Locked Borders, Seams)
+        for (auto &ratio : settings.ratios)
+        {   float error; std::size_t target = static_cast<std::size_t>(indexCount * ratio) / 3 * 3;
+            auto lod = simplify(positions, stride, vertexCount, indices, indexCount, target, error);
+            if (lod.size() >= static_cast<std::size_t>(mLods.back().count)) break;
+            mLods.push_back(Lod{ levels.size(), static_cast<GLsizei>(lod.size()), error });
+            levels.insert(levels.end(), lod.begin(), lod.end());
+            indices = levels.data(); // insert() May Have Moved Full Detail
+        }   return levels;
+    }
+
+    void Mesh::upload(Vertex const * vertices, std::size_t vertexCount,
+                      GLuint const * indices,  std::size_t indexCount, bool triangles)
     {
         // Bind a Vertex Array Object
         glGenVertexArrays(1, & mVertexArray);
@@ -41,15 +177,26 @@ namespace Mirage
         glGenBuffers(1, & mVertexBuffer);
         glBindBuffer(GL_ARRAY_BUFFER, mVertexBuffer);
         glBufferData(GL_ARRAY_BUFFER,
-                     mVertices.size() * sizeof(Vertex),
-                   & mVertices.front(), GL_STATIC_DRAW);
+                     vertexCount * sizeof(Vertex),
+                     vertices, GL_STATIC_DRAW);
 
-        // Copy Index Buffer Data
+        // Copy Index Buffer Data; Every Level Lives in the One Buffer
+        auto levels = cook(vertexCount ? & vertices[0].position.x : nullptr, sizeof(Vertex), vertexCount,
+                           std::vector<GLuint>(indices, indices + indexCount), triangles);
         glGenBuffers(1, & mElementBuffer);
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mElementBuffer);
         glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-                     mIndices.size() * sizeof(GLuint),
-                   & mIndices.front(), GL_STATIC_DRAW);
+                     levels.size() * sizeof(GLuint),
+                     levels.data(), GL_STATIC_DRAW);
+        mIndexCount = static_cast<GLsizei>(indexCount);
+
+        // Record Bounds While the Vertices are Still at Hand
+        mBounded = vertexCount > 0;
+        if (mBounded) mMin = mMax = vertices[0].position;
+        for (std::size_t i = 1; i < vertexCount; i++)
+        {   mMin = glm::min(mMin, vertices[i].position);
+            mMax = glm::max(mMax, vertices[i].position);
+        }
 
         // Set Shader Attributes
         glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (GLvoid *) offsetof(Vertex, position));
@@ -58,29 +205,238 @@ namespace Mirage
         glEnableVertexAttribArray(0); // Vertex Positions
         glEnableVertexAttribArray(1); // Vertex Normals
         glEnableVertexAttribArray(2); // Vertex UVs
-
-        // Cleanup Buffers
         glBindVertexArray(0);
-        glDeleteBuffers(1, & mVertexBuffer);
-        glDeleteBuffers(1, & mElementBuffer);
+
+        // Record GPU Memory Use
+        auto & registry = resourceRegistry();
+        registry.track(mVertexBuffer,  vertexCount * sizeof(Vertex), ResourceCategory::VertexBuffer, "Mirage::Mesh");
+        registry.track(mElementBuffer, levels.size() * sizeof(GLuint), ResourceCategory::IndexBuffer, "Mirage::Mesh");
+
+        // Keep CPU Copies Unless Someone Turned Them Off
+        if (!registry.retainCpuCopies()) return;
+        mVertices.assign(vertices, vertices + vertexCount);
+        mIndices = std::move(levels);
+        registry.track(reinterpret_cast<std::uintptr_t>(this),
+                       vertexCount * sizeof(Vertex) + mIndices.size() * sizeof(GLuint),
+                       ResourceCategory::CpuGeometry, "Mirage::Mesh");
     }
 
-    void Mesh::draw(GLuint shader)
+    void Mesh::draw(GLuint shader, Occlusion * occlusion)
     {
         unsigned int unit = 0, diffuse = 0, specular = 0;
-        for (auto &i : mSubMeshes) i->draw(shader);
+        for (auto &i : mSubMeshes) i->draw(shader, occlusion);
+
+        // Skip Texture Binds Too When the Occlusion Test Already Failed
+        bool culled = occlusion && mSlot >= 0;
+        if (culled && !occlusion->visible(mSlot)) return;
         for (auto &i : mTextures)
         {   // Set Correct Uniform Names Using Texture Type (Omit ID for 0th Texture)
-            std::string uniform = i.second;
-                 if (i.second == "diffuse")  uniform += (diffuse++  > 0) ? std::to_string(diffuse)  : "";
-            else if (i.second == "specular") uniform += (specular++ > 0) ? std::to_string(specular) : "";
+            unsigned int id = 0;
+                 if (i.second == "diffuse")  id = diffuse++;
+            else if (i.second == "specular") id = specular++;
+
+            // Format the Name on the Stack to Keep the Heap Out of Draw Calls
+            char uniform[32];
+            if (id > 0) snprintf(uniform, sizeof uniform, "%s%u", i.second.c_str(), id + 1);
+            else        snprintf(uniform, sizeof uniform, "%s",   i.second.c_str());
 
             // Bind Correct Textures and Vertex Array Before Drawing
             glActiveTexture(GL_TEXTURE0 + unit);
             glBindTexture(GL_TEXTURE_2D, i.first);
-            glUniform1f(glGetUniformLocation(shader, uniform.c_str()), ++unit);
+            glUniform1f(glGetUniformLocation(shader, uniform), ++unit);
         }   glBindVertexArray(mVertexArray);
-            glDrawElements(GL_TRIANGLES, mIndices.size(), GL_UNSIGNED_INT, 0);
+            if (culled) occlusion->draw(mSlot);
+            else if (mIndexType == GL_NONE) glDrawArrays(GL_TRIANGLES, 0, mIndexCount);
+            else glDrawElements(GL_TRIANGLES, mIndexCount, mIndexType, (GLvoid *) mIndexOffset);
+    }
+
+    void Mesh::cull(Occlusion & occlusion, glm::mat4 const & model)
+    {
+        for (auto &i : mSubMeshes) i->cull(occlusion, model);
+        if (!mBounded || mIndexCount == 0) return;
+
+        // Transform All Eight Corners to Get a World-Space Box
+        glm::vec3 min, max;
+        for (int i = 0; i < 8; i++)
+        {   glm::vec4 corner = model * glm::vec4(i & 1 ? mMax.x : mMin.x,
+                                                 i & 2 ? mMax.y : mMin.y,
+                                                 i & 4 ? mMax.z : mMin.z, 1.0f);
+            glm::vec3 world(corner.x, corner.y, corner.z);
+            min = i ? glm::min(min, world) : world;
+            max = i ? glm::max(max, world) : world;
+        }
+        if (mSlot < 0) mSlot = static_cast<GLint>(occlusion.add(min, max, mIndexCount, mIndexType, mIndexOffset));
+        else occlusion.move(mSlot, min, max);
+    }
+
+    void Mesh::lod(glm::mat4 const & model, glm::vec3 const & eye,
+                   float projection, Occlusion * occlusion)
+    {
+        for (auto &i : mSubMeshes) i->lod(model, eye, projection, occlusion);
+        if (mLods.size() < 2 || !mBounded) return;
+
+        // Distance to the Bounding Sphere, Scaled Like its Longest Model Axis
+        float scale = std::max(glm::length(glm::vec3(model[0])),
+                      std::max(glm::length(glm::vec3(model[1])),
+                               glm::length(glm::vec3(model[2]))));
+        glm::vec4 center = model * glm::vec4((mMin + mMax) * 0.5f, 1.0f);
+        float radius   = glm::length(mMax - mMin) * 0.5f * scale;
+        float distance = std::max(glm::length(glm::vec3(center) - eye) - radius, 1e-3f);
+        auto pixels = [&](std::size_t level) { return mLods[level].error * scale * projection / distance; };
+
+        // Move a Level at a Time, and Only Once Past the Hysteresis Band
+        LodSettings const & settings = lodSettings();
+        std::size_t level = mLod;
+        while (level > 0 && pixels(level) > settings.threshold * (1.0f + settings.hysteresis)) level--;
+        while (level + 1 < mLods.size() && pixels(level + 1) <= settings.threshold * (1.0f - settings.hysteresis)) level++;
+        if (level == mLod) return;
+
+        mLod = level;
+        mIndexCount  = mLods[level].count;
+        mIndexOffset = mLods[level].offset * mIndexSize;
+        if (occlusion && mSlot >= 0) occlusion->range(mSlot, mIndexCount, mIndexOffset);
+    }
+
+    GLsizei Mesh::triangles() const
+    {
+        GLsizei count = mIndexCount / 3;
+        for (auto &i : mSubMeshes) count += i->triangles();
+        return count;
+    }
+
+    std::vector<GLuint> Mesh::cook(Gltf const & gltf, GltfPrimitive const & primitive)
+    {
+        // Check Eligibility First so Skipped Primitives Stay Zero-Copy
+        GltfAccessor const & position = gltf.mAccessors[primitive.position];
+        GltfAccessor const & a = gltf.mAccessors[primitive.indices];
+        bool floats = position.componentType == GL_FLOAT && position.components == 3;
+        if (!cookable(static_cast<std::size_t>(a.count), floats))
+        {   mLods.assign(1, Lod{ 0, a.count, 0.0f });
+            return std::vector<GLuint>();
+        }
+
+        // Widen the Mapped Indices
+        unsigned char const * data = gltf.view(a.bufferView) + a.byteOffset;
+        std::vector<GLuint> indices(a.count);
+        for (std::size_t j = 0; j < indices.size(); j++)
+                 if (a.componentType == GL_UNSIGNED_BYTE)  indices[j] = data[j];
+            else if (a.componentType == GL_UNSIGNED_SHORT) { GLushort v; std::memcpy(& v, data + j * 2, 2); indices[j] = v; }
+            else std::memcpy(& indices[j], data + j * 4, 4);
+
+        // Positions Stay in the Mapping, Read with the File's Own Stride
+        GLsizei stride = gltf.mBufferViews[position.bufferView].byteStride;
+        auto positions = reinterpret_cast<float const *>(gltf.view(position.bufferView) + position.byteOffset);
+        return cook(positions, stride ? stride : 3 * sizeof(float), position.count,
+                    std::move(indices), true);
+    }
+
+    bool Mesh::parse(std::string const & path, std::string const & filename)
+    {
+        // Map the File; Anything Unsupported Falls Back to Assimp
+        std::unique_ptr<Gltf> gltf;
+        try { gltf.reset(new Gltf(PROJECT_SOURCE_DIR "/Mirage/Models/" + filename)); }
+        catch (std::runtime_error const & error)
+        {   fprintf(stderr, "%s, Falling Back to Assimp\n", error.what());
+            return false;
+        }
+
+        // Upload Each Buffer View Once, Straight from the Mapped File
+        auto & registry = resourceRegistry();
+        std::vector<GLuint> views(gltf->mBufferViews.size(), 0);
+        auto buffer = [&](int accessor, GLenum target, ResourceCategory category)
+        {
+            int index = gltf->mAccessors[accessor].bufferView;
+            if (views[index] == 0)
+            {   glGenBuffers(1, & views[index]);
+                glBindBuffer(target, views[index]);
+                glBufferData(target, gltf->mBufferViews[index].byteLength,
+                             gltf->view(index), GL_STATIC_DRAW);
+                registry.track(views[index], gltf->mBufferViews[index].byteLength, category, filename);
+                mBuffers.push_back(views[index]);
+            }   glBindBuffer(target, views[index]);
+        };
+
+        // Point Attributes at the Views with the File's Own Strides and Offsets
+        auto attribute = [&](GLuint location, int accessor)
+        {
+            if (accessor < 0) return;
+            GltfAccessor const & a = gltf->mAccessors[accessor];
+            buffer(accessor, GL_ARRAY_BUFFER, ResourceCategory::VertexBuffer);
+            glVertexAttribPointer(location, a.components, a.componentType, a.normalized,
+                                  gltf->mBufferViews[a.bufferView].byteStride, (GLvoid *) a.byteOffset);
+            glEnableVertexAttribArray(location);
+        };
+
+        for (auto &i : gltf->mPrimitives)
+        {
+            // Bind a Vertex Array Object; glTF UVs Already Match stb's Row Order
+            std::unique_ptr<Mesh> mesh(new Mesh());
+            glBindVertexArray(mesh->mVertexArray);
+            attribute(0, i.position); // Vertex Positions
+            attribute(1, i.normal);   // Vertex Normals
+            attribute(2, i.uv);       // Vertex UVs
+
+            // Indexed Primitives Draw Straight from the Index View, Unless They
+            // Cook Levels of Detail; Those Get Their Own Buffer of Every Level
+            if (i.indices >= 0)
+            {   GltfAccessor const & a = gltf->mAccessors[i.indices];
+                auto levels = mesh->cook(*gltf, i);
+                mesh->mIndexType  = a.componentType;
+                mesh->mIndexCount = a.count;
+                if (mesh->mLods.size() < 2)
+                {   buffer(i.indices, GL_ELEMENT_ARRAY_BUFFER, ResourceCategory::IndexBuffer);
+                    mesh->mIndexOffset = a.byteOffset;
+                }
+                else
+                {   // Simplified Indices are a Subset, so They Fit the File's Type
+                    std::size_t size = a.componentType == GL_UNSIGNED_BYTE  ? 1
+                                     : a.componentType == GL_UNSIGNED_SHORT ? 2 : 4;
+                    std::vector<unsigned char> bytes(levels.size() * size);
+                    for (std::size_t j = 0; j < levels.size(); j++)
+                             if (size == 1) bytes[j] = static_cast<unsigned char>(levels[j]);
+                        else if (size == 2) { GLushort v = static_cast<GLushort>(levels[j]); std::memcpy(& bytes[j * 2], & v, 2); }
+                        else std::memcpy(& bytes[j * 4], & levels[j], 4);
+                    glGenBuffers(1, & mesh->mElementBuffer);
+                    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->mElementBuffer);
+                    glBufferData(GL_ELEMENT_ARRAY_BUFFER, bytes.size(), bytes.data(), GL_STATIC_DRAW);
+                    registry.track(mesh->mElementBuffer, bytes.size(), ResourceCategory::IndexBuffer, filename);
+                    mesh->mIndexOffset = 0;
+                    mesh->mIndexSize   = size;
+                }
+            }
+            else
+            {   mesh->mIndexType  = GL_NONE;
+                mesh->mIndexCount = gltf->mAccessors[i.position].count;
+            }   glBindVertexArray(0);
+
+            // Positions Carry Their Bounds in the Header
+            GltfAccessor const & position = gltf->mAccessors[i.position];
+            mesh->mBounded = position.bounded;
+            if (position.bounded)
+            {   mesh->mMin = glm::vec3(position.min[0], position.min[1], position.min[2]);
+                mesh->mMax = glm::vec3(position.max[0], position.max[1], position.max[2]);
+            }
+
+            // Decode the Base Color Image, Embedded or Alongside the Model
+            if (i.image >= 0 && i.image < static_cast<int>(gltf->mImages.size()))
+            {
+                GltfImage const & image = gltf->mImages[i.image];
+                std::string name = filename + "#image" + std::to_string(i.image);
+                int width, height, channels; unsigned char * pixels = nullptr;
+                if (image.bufferView >= 0 && image.bufferView < static_cast<int>(gltf->mBufferViews.size()))
+                    pixels = stbi_load_from_memory(gltf->view(image.bufferView),
+                                                   static_cast<int>(gltf->mBufferViews[image.bufferView].byteLength),
+                                                   & width, & height, & channels, 0);
+                else if (!image.uri.empty())
+                {   name = PROJECT_SOURCE_DIR "/Mirage/Models/" + path + "/" + image.uri;
+                    pixels = stbi_load(name.c_str(), & width, & height, & channels, 0);
+                }
+                if (!pixels) fprintf(stderr, "%s %s\n", "Failed to Load Texture", name.c_str());
+                else mesh->mTextures.insert(std::make_pair(texture(pixels, width, height, channels, name), "diffuse"));
+                stbi_image_free(pixels);
+            }
+            mSubMeshes.push_back(std::move(mesh));
+        }   return true;
     }
 
     void Mesh::parse(std::string const & path, aiNode const * node, aiScene const * scene)
@@ -94,7 +450,8 @@ namespace Mirage
     void Mesh::parse(std::string const & path, aiMesh const * mesh, aiScene const * scene)
     {
         // Create Vertex Data from Mesh Node
-        std::vector<Vertex> vertices; Vertex vertex;
+        ArenaVector<Vertex> vertices(scratchArena()); Vertex vertex;
+        vertices.reserve(mesh->mNumVertices);
         for (unsigned int i = 0; i < mesh->mNumVertices; i++)
         {   if (mesh->mTextureCoords[0])
             vertex.uv       = glm::vec2(mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y);
@@ -104,7 +461,8 @@ namespace Mirage
         }
 
         // Create Mesh Indices for Indexed Drawing
-        std::vector<GLuint> indices;
+        ArenaVector<GLuint> indices(scratchArena());
+        indices.reserve(mesh->mNumFaces * 3);
         for (unsigned int i = 0; i < mesh->mNumFaces; i++)
         for (unsigned int j = 0; j < mesh->mFaces[i].mNumIndices; j++)
             indices.push_back(mesh->mFaces[i].mIndices[j]);
@@ -116,8 +474,12 @@ namespace Mirage
         textures.insert(diffuse.begin(), diffuse.end());
         textures.insert(specular.begin(), specular.end());
 
-        // Create New Mesh Node
-        mSubMeshes.push_back(std::unique_ptr<Mesh>(new Mesh(vertices, indices, textures)));
+        // Create New Mesh Node; SortByPType Leaves Line and Point Meshes Behind Too
+        bool triangles = mesh->mPrimitiveTypes == aiPrimitiveType_TRIANGLE;
+        mSubMeshes.push_back(std::unique_ptr<Mesh>(new Mesh(vertices, indices, textures, triangles)));
+
+        // Scratch Data is Copied Out, so Recycle it for the Next Sub-Mesh
+        scratchArena().reset();
     }
 
     std::map<GLuint, std::string> Mesh::process(std::string const & path,
@@ -128,8 +490,6 @@ namespace Mirage
         for(unsigned int i = 0; i < material->GetTextureCount(type); i++)
         {
             // Define Some Local Variables
-            GLenum format;
-            GLuint texture;
             std::string mode;
 
             // Load the Texture Image from File
@@ -137,33 +497,17 @@ namespace Mirage
             std::string filename = str.C_Str(); int width, height, channels;
             filename = PROJECT_SOURCE_DIR "/Mirage/Models/" + path + "/" + filename;
             unsigned char * image = stbi_load(filename.c_str(), & width, & height, & channels, 0);
-            if (!image) fprintf(stderr, "%s %s\n", "Failed to Load Texture", filename.c_str());
-
-            // Set the Correct Channel Format
-            switch (channels)
-            {
-                case 1 : format = GL_ALPHA;     break;
-                case 2 : format = GL_LUMINANCE; break;
-                case 3 : format = GL_RGB;       break;
-                case 4 : format = GL_RGBA;      break;
+            if (!image)
+            {   fprintf(stderr, "%s %s\n", "Failed to Load Texture", filename.c_str());
+                continue;
             }
 
-            // Bind Texture and Set Filtering Levels
-            glGenTextures(1, & texture);
-            glBindTexture(GL_TEXTURE_2D, texture);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_NEAREST);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-            glTexImage2D(GL_TEXTURE_2D, 0, format,
-                         width, height, 0, format, GL_UNSIGNED_BYTE, image);
-            glGenerateMipmap(GL_TEXTURE_2D);
-
-            // Release Image Pointer and Store the Texture
+            // Upload and Store the Texture
+            GLuint id = texture(image, width, height, channels, filename);
             stbi_image_free(image);
                  if (type == aiTextureType_DIFFUSE)  mode = "diffuse";
             else if (type == aiTextureType_SPECULAR) mode = "specular";
-            textures.insert(std::make_pair(texture, mode));
+            textures.insert(std::make_pair(id, mode));
         }   return textures;
     }
 };
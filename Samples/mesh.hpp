@@ -7,6 +7,13 @@
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 
+// Local Headers
+#include "LinearArena.hpp"
+#include "gltf.hpp"
+#include "occlusion.hpp"
+#include "ResourceRegistry.hpp"
+#include "simplify.hpp"
+
 // Standard Headers
 #include <map>
 #include <memory>
@@ -28,16 +35,38 @@ namespace Mirage
 
         // Implement Default Constructor and Destructor
          Mesh() { glGenVertexArrays(1, & mVertexArray); }
-        ~Mesh() { glDeleteVertexArrays(1, & mVertexArray); }
+        ~Mesh();
+
+        // Importers: Auto Takes the Zero-Copy Path for .glb, Assimp Otherwise
+        enum class Loader { Auto, Assimp };
 
         // Implement Custom Constructors
-        Mesh(std::string const & filename);
+        Mesh(std::string const & filename, Loader loader = Loader::Auto);
         Mesh(std::vector<Vertex> const & vertices,
              std::vector<GLuint> const & indices,
              std::map<GLuint, std::string> const & textures);
+        Mesh(ArenaVector<Vertex> const & vertices,
+             ArenaVector<GLuint> const & indices,
+             std::map<GLuint, std::string> const & textures,
+             bool triangles = true);
 
         // Public Member Functions
-        void draw(GLuint shader);
+        void draw(GLuint shader, Occlusion * occlusion = nullptr);
+
+        // Register Sub-Mesh Bounds, Placed by model, for Occlusion Culling
+        void cull(Occlusion & occlusion, glm::mat4 const & model);
+
+        // Pick Each Sub-Mesh's Level of Detail by Projected Error. projection is
+        // Viewport Height / (2 * tan(fovy / 2)); Pass the Occlusion Culler the
+        // Mesh was Registered With so its Draws Follow
+        void lod(glm::mat4 const & model, glm::vec3 const & eye,
+                 float projection, Occlusion * occlusion = nullptr);
+
+        // Triangles Drawn at the Currently Selected Levels
+        GLsizei triangles() const;
+
+        // Print Load Times of Both Importers on the Same Model
+        static void benchmark(std::string const & filename);
 
     private:
 
@@ -46,22 +75,57 @@ namespace Mirage
         Mesh & operator=(Mesh const &) = delete;
 
         // Private Member Functions
+        void upload(Vertex const * vertices, std::size_t vertexCount,
+                    GLuint const * indices,  std::size_t indexCount, bool triangles);
+
+        // Fill mLods and Return Every Level's Indices Back to Back, Full Detail
+        // (Passed in as levels) First. Only Triangle Lists (triangles, and a
+        // Multiple of 3) Simplify. The glTF Overload Returns Nothing and
+        // Copies Nothing Unless the Primitive Gets More than One Level.
+        std::vector<GLuint> cook(float const * positions, std::size_t stride, std::size_t vertexCount,
+                                 std::vector<GLuint> levels, bool triangles);
+        std::vector<GLuint> cook(Gltf const & gltf, GltfPrimitive const & primitive);
+        bool parse(std::string const & path, std::string const & filename);
         void parse(std::string const & path, aiNode const * node, aiScene const * scene);
         void parse(std::string const & path, aiMesh const * mesh, aiScene const * scene);
         std::map<GLuint, std::string> process(std::string const & path,
                                               aiMaterial * material,
                                               aiTextureType type);
 
-        // Private Member Containers
+        // Private Member Containers (Vertex and Index Copies are Kept by Default;
+        // Empty if resourceRegistry().setRetainCpuCopies(false) Came First)
         std::vector<std::unique_ptr<Mesh>> mSubMeshes;
         std::vector<GLuint> mIndices;
         std::vector<Vertex> mVertices;
         std::map<GLuint, std::string> mTextures;
+        std::vector<GLuint> mBuffers; // glTF Buffer Views Shared by Sub-Meshes
 
         // Private Member Variables
         GLuint mVertexArray;
-        GLuint mVertexBuffer;
-        GLuint mElementBuffer;
+        GLuint mVertexBuffer  = 0;
+        GLuint mElementBuffer = 0;
+        GLsizei mIndexCount   = 0;
+        GLenum  mIndexType    = GL_UNSIGNED_INT; // GL_NONE for Non-Indexed
+        std::size_t mIndexOffset = 0;
+        std::size_t mIndexSize   = sizeof(GLuint); // Bytes per Index in mElementBuffer
+
+        // Object-Space Bounds and Occlusion Slot (-1 Until Registered)
+        bool mBounded = false;
+        glm::vec3 mMin;
+        glm::vec3 mMax;
+        GLint mSlot = -1;
+
+        // Loaded Through the Zero-Copy glTF Path Rather than Assimp
+        bool mGltf = false;
+
+        // Levels of Detail as Ranges of the Element Buffer, Finest First
+        struct Lod {
+            std::size_t offset; // In Indices
+            GLsizei     count;
+            float       error;  // Object-Space Distance
+        };
+        std::vector<Lod> mLods;
+        std::size_t mLod = 0;
 
     };
 };
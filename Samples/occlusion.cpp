@@ -0,0 +1,316 @@
+// Local Headers
+#include "occlusion.hpp"
+#include "ResourceRegistry.hpp"
+
+// Standard Headers
+#include <algorithm>
+
+// Define Namespace
+namespace Mirage
+{
+    static std::size_t indexSize(GLenum type)
+    {
+        switch (type)
+        {
+            case GL_UNSIGNED_BYTE  : return 1;
+            case GL_UNSIGNED_SHORT : return 2;
+            default                : return 4;
+        }
+    }
+
+    Occlusion::Occlusion(GLsizei width, GLsizei height, bool allowCompute)
+        : mWidth(width), mHeight(height)
+        , mCompute(allowCompute && GLAD_GL_VERSION_4_3)
+        , mViewProjection(1.0f)
+    {
+        // Level Sizes Round Down Like OpenGL Mipmaps
+        for (glm::ivec2 size(width, height);; size = glm::ivec2(std::max(1, size.x / 2), std::max(1, size.y / 2)))
+        {   mSizes.push_back(size);
+            if (size.x == 1 && size.y == 1) break;
+        }
+        if (!mCompute)
+        {   mLevels.resize(mSizes.size());
+            for (std::size_t i = 0; i < mSizes.size(); i++)
+                mLevels[i].resize(mSizes[i].x * mSizes[i].y);
+            return;
+        }
+
+        // Depth Snapshot and Max-Depth Pyramid Textures
+        glGenTextures(1, & mDepth);
+        glBindTexture(GL_TEXTURE_2D, mDepth);
+        glTexStorage2D(GL_TEXTURE_2D, 1, GL_DEPTH_COMPONENT32F, width, height);
+        glGenTextures(1, & mPyramid);
+        glBindTexture(GL_TEXTURE_2D, mPyramid);
+        glTexStorage2D(GL_TEXTURE_2D, static_cast<GLsizei>(mSizes.size()), GL_R32F, width, height);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        auto & registry = resourceRegistry();
+        registry.track(mDepth,   textureBytes(width, height, 4, false), ResourceCategory::Texture, "Mirage::Occlusion");
+        registry.track(mPyramid, textureBytes(width, height, 4, true),  ResourceCategory::Texture, "Mirage::Occlusion");
+
+        // Boxes, Indirect Commands, and Drawn/Occluded Counters
+        GLuint buffers[4];
+        glGenBuffers(4, buffers);
+        mBoxBuffer = buffers[0]; mCommandBuffer = buffers[1];
+        mCounterBuffer = buffers[2]; mReadback = buffers[3];
+        glBindBuffer(GL_COPY_WRITE_BUFFER, mCounterBuffer);
+        glBufferData(GL_COPY_WRITE_BUFFER, 2 * sizeof(GLuint), nullptr, GL_DYNAMIC_COPY);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, mReadback);
+        glBufferData(GL_COPY_WRITE_BUFFER, 2 * sizeof(GLuint), nullptr, GL_STREAM_READ);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        registry.track(mCounterBuffer, 2 * sizeof(GLuint), ResourceCategory::OtherBuffer, "Mirage::Occlusion");
+        registry.track(mReadback,      2 * sizeof(GLuint), ResourceCategory::OtherBuffer, "Mirage::Occlusion");
+
+        // Build the Kernels and Look Up Their Uniforms Once
+        mBuild.reset(new Shader());
+        mCull.reset(new Shader());
+        mBuild->attach("hiz_build.comp").link();
+        mCull->attach("hiz_cull.comp").link();
+        mDepthUniform          = glGetUniformLocation(mBuild->get(), "uDepth");
+        mCopyUniform           = glGetUniformLocation(mBuild->get(), "uCopy");
+        mPyramidUniform        = glGetUniformLocation(mCull->get(),  "uPyramid");
+        mViewProjectionUniform = glGetUniformLocation(mCull->get(),  "uViewProjection");
+        mCountUniform          = glGetUniformLocation(mCull->get(),  "uCount");
+        mLevelsUniform         = glGetUniformLocation(mCull->get(),  "uLevels");
+    }
+
+    Occlusion::~Occlusion()
+    {
+        if (!mCompute) return;
+        if (mFence) glDeleteSync(mFence);
+        GLuint buffers[] = { mBoxBuffer, mCommandBuffer, mCounterBuffer, mReadback };
+        auto & registry = resourceRegistry();
+        for (auto &i : buffers) registry.release(i, ResourceCategory::OtherBuffer);
+        registry.release(mDepth,   ResourceCategory::Texture);
+        registry.release(mPyramid, ResourceCategory::Texture);
+        glDeleteBuffers(4, buffers);
+        glDeleteTextures(1, & mDepth);
+        glDeleteTextures(1, & mPyramid);
+    }
+
+    GLuint Occlusion::add(glm::vec3 const & min, glm::vec3 const & max,
+                          GLsizei count, GLenum type, std::size_t offset)
+    {
+        // Non-Indexed Draws Read the Same Buffer as DrawArraysIndirectCommand
+        Command command = { static_cast<GLuint>(count), 1, 0, 0, 0 };
+        if (type != GL_NONE) command.first = static_cast<GLuint>(offset / indexSize(type));
+        mBoxes.push_back(Box{ glm::vec4(min, 1.0f), glm::vec4(max, 1.0f) });
+        mCommands.push_back(command);
+        mTypes.push_back(type);
+        mOffsets.push_back(offset);
+        mVisible.push_back(true);
+        mDirty = true;
+        return static_cast<GLuint>(mBoxes.size() - 1);
+    }
+
+    void Occlusion::move(GLuint slot, glm::vec3 const & min, glm::vec3 const & max)
+    {
+        mBoxes[slot] = Box{ glm::vec4(min, 1.0f), glm::vec4(max, 1.0f) };
+        mDirty = true;
+    }
+
+    void Occlusion::range(GLuint slot, GLsizei count, std::size_t offset)
+    {
+        mCommands[slot].count = static_cast<GLuint>(count);
+        if (mTypes[slot] != GL_NONE) mCommands[slot].first = static_cast<GLuint>(offset / indexSize(mTypes[slot]));
+        mOffsets[slot] = offset;
+        mDirty = true;
+    }
+
+    void Occlusion::test()
+    {
+        if (mCompute) return testCompute();
+
+        // Without a Pyramid Yet, Everything is Potentially Visible
+        mDrawn = mOccluded = 0;
+        for (std::size_t i = 0; i < mBoxes.size(); i++)
+        {   mVisible[i] = !mCaptured || test(mBoxes[i]);
+            if (mVisible[i]) mDrawn++; else mOccluded++;
+        }
+    }
+
+    bool Occlusion::test(Box const & box) const
+    {
+        // Project the Corners; Boxes Crossing the Near Plane Stay Visible
+        float loX = 1e30f, loY = 1e30f, hiX = -1e30f, hiY = -1e30f, nearest = 1.0f;
+        for (int i = 0; i < 8; i++)
+        {   glm::vec4 corner(i & 1 ? box.max.x : box.min.x,
+                             i & 2 ? box.max.y : box.min.y,
+                             i & 4 ? box.max.z : box.min.z, 1.0f);
+            glm::vec4 clip = mViewProjection * corner;
+            if (clip.w <= 1e-5f) return true;
+            float x = clip.x / clip.w * 0.5f + 0.5f;
+            float y = clip.y / clip.w * 0.5f + 0.5f;
+            loX = std::min(loX, x); hiX = std::max(hiX, x);
+            loY = std::min(loY, y); hiY = std::max(hiY, y);
+            nearest = std::min(nearest, clip.z / clip.w * 0.5f + 0.5f);
+        }
+
+        // Off-Screen Boxes are Frustum Culling's Job, Not Ours
+        if (hiX < 0.0f || hiY < 0.0f || loX > 1.0f || loY > 1.0f) return true;
+        int x0 = std::min(std::max(static_cast<int>(loX * mWidth),  0), mWidth  - 1);
+        int x1 = std::min(std::max(static_cast<int>(hiX * mWidth),  0), mWidth  - 1);
+        int y0 = std::min(std::max(static_cast<int>(loY * mHeight), 0), mHeight - 1);
+        int y1 = std::min(std::max(static_cast<int>(hiY * mHeight), 0), mHeight - 1);
+
+        // Pick the Finest Level Where the Rect Spans at Most 2x2 Texels
+        int level = 0, levels = static_cast<int>(mSizes.size());
+        while (level + 1 < levels && ((x1 >> level) - (x0 >> level) > 1
+                                   || (y1 >> level) - (y0 >> level) > 1)) level++;
+
+        // Occluded Only if the Whole Box is Behind the Farthest Depth There
+        glm::ivec2 size = mSizes[level];
+        float farthest = 0.0f;
+        for (int y = std::min(y0 >> level, size.y - 1); y <= std::min(y1 >> level, size.y - 1); y++)
+        for (int x = std::min(x0 >> level, size.x - 1); x <= std::min(x1 >> level, size.x - 1); x++)
+            farthest = std::max(farthest, mLevels[level][y * size.x + x]);
+        return nearest <= farthest;
+    }
+
+    bool Occlusion::visible(GLuint slot) const
+    {
+        return mCompute || mVisible[slot];
+    }
+
+    void Occlusion::draw(GLuint slot) const
+    {
+        if (mCompute)
+        {   // The Cull Pass Zeroed instanceCount if the Slot is Hidden
+            auto indirect = (GLvoid const *) (slot * sizeof(Command));
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, mCommandBuffer);
+            if (mTypes[slot] == GL_NONE) glDrawArraysIndirect(GL_TRIANGLES, indirect);
+            else glDrawElementsIndirect(GL_TRIANGLES, mTypes[slot], indirect);
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        }
+        else if (mVisible[slot])
+        {   Command const & command = mCommands[slot];
+            if (mTypes[slot] == GL_NONE) glDrawArrays(GL_TRIANGLES, 0, command.count);
+            else glDrawElements(GL_TRIANGLES, command.count, mTypes[slot], (GLvoid *) mOffsets[slot]);
+        }
+    }
+
+    void Occlusion::capture(glm::mat4 const & viewProjection)
+    {
+        mViewProjection = viewProjection;
+        mCaptured = true;
+        if (mCompute)
+        {   // Copy the Bound Framebuffer's Depth Without Leaving the GPU
+            glBindTexture(GL_TEXTURE_2D, mDepth);
+            glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 0, 0, mWidth, mHeight);
+            glBindTexture(GL_TEXTURE_2D, 0);
+        }
+        else
+        {   // Read Back Depth; Slow, but Works on Any Rasterizer
+            glReadPixels(0, 0, mWidth, mHeight, GL_DEPTH_COMPONENT, GL_FLOAT, mLevels[0].data());
+        }   buildPyramid();
+    }
+
+    void Occlusion::buildPyramid()
+    {
+        if (!mCompute)
+        {   for (std::size_t i = 1; i < mLevels.size(); i++)
+            {   glm::ivec2 size = mSizes[i], source = mSizes[i - 1];
+                for (int y = 0; y < size.y; y++)
+                for (int x = 0; x < size.x; x++)
+                {   // Mirror the Shader: Edge Texels Absorb an Odd Parent's Leftovers
+                    int extentX = 2 + (x == size.x - 1 ? source.x & 1 : 0);
+                    int extentY = 2 + (y == size.y - 1 ? source.y & 1 : 0);
+                    float depth = 0.0f;
+                    for (int v = 0; v < extentY; v++)
+                    for (int u = 0; u < extentX; u++)
+                    {   int sx = std::min(x * 2 + u, source.x - 1);
+                        int sy = std::min(y * 2 + v, source.y - 1);
+                        depth = std::max(depth, mLevels[i - 1][sy * source.x + sx]);
+                    }   mLevels[i][y * size.x + x] = depth;
+                }
+            }   return;
+        }
+
+        // Level 0 is a Copy of the Depth Snapshot; Each Later Level Reduces the Previous
+        mBuild->activate();
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, mDepth);
+        glUniform1i(mDepthUniform, 0);
+        for (std::size_t i = 0; i < mSizes.size(); i++)
+        {   glUniform1i(mCopyUniform, i == 0);
+            glBindImageTexture(0, mPyramid, static_cast<GLint>(i), GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+            if (i > 0) glBindImageTexture(1, mPyramid, static_cast<GLint>(i - 1), GL_FALSE, 0, GL_READ_ONLY, GL_R32F);
+            glDispatchCompute((mSizes[i].x + 7) / 8, (mSizes[i].y + 7) / 8, 1);
+            glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT);
+        }   glBindTexture(GL_TEXTURE_2D, 0);
+            glUseProgram(0);
+    }
+
+    void Occlusion::testCompute()
+    {
+        // Collect Last Frame's Counters Only Once the GPU is Done With Them
+        if (mFence && glClientWaitSync(mFence, 0, 0) != GL_TIMEOUT_EXPIRED)
+        {   GLuint counts[2];
+            glBindBuffer(GL_COPY_READ_BUFFER, mReadback);
+            glGetBufferSubData(GL_COPY_READ_BUFFER, 0, sizeof counts, counts);
+            glBindBuffer(GL_COPY_READ_BUFFER, 0);
+            mDrawn = counts[0]; mOccluded = counts[1];
+            glDeleteSync(mFence); mFence = nullptr;
+        }
+
+        // Re-Upload Boxes and Commands When Slots Move or Change Range; Only
+        // Re-Specify (and Re-Track) the Buffers When add() Grew Them, so
+        // Steady-State Frames Stay Off the Heap
+        if (mDirty && mBoxes.size() != mUploaded)
+        {   glBindBuffer(GL_SHADER_STORAGE_BUFFER, mBoxBuffer);
+            glBufferData(GL_SHADER_STORAGE_BUFFER, mBoxes.size() * sizeof(Box), mBoxes.data(), GL_DYNAMIC_DRAW);
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, mCommandBuffer);
+            glBufferData(GL_SHADER_STORAGE_BUFFER, mCommands.size() * sizeof(Command), mCommands.data(), GL_DYNAMIC_DRAW);
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+            auto & registry = resourceRegistry();
+            registry.track(mBoxBuffer,     mBoxes.size()    * sizeof(Box),     ResourceCategory::OtherBuffer, "Mirage::Occlusion");
+            registry.track(mCommandBuffer, mCommands.size() * sizeof(Command), ResourceCategory::OtherBuffer, "Mirage::Occlusion");
+            mUploaded = mBoxes.size();
+            mDirty = false;
+        }
+        else if (mDirty)
+        {   glBindBuffer(GL_SHADER_STORAGE_BUFFER, mBoxBuffer);
+            glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, mBoxes.size() * sizeof(Box), mBoxes.data());
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, mCommandBuffer);
+            glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, mCommands.size() * sizeof(Command), mCommands.data());
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+            mDirty = false;
+        }
+        if (!mCaptured || mBoxes.empty())
+        {   mDrawn = static_cast<GLuint>(mBoxes.size()); mOccluded = 0;
+            return;
+        }
+
+        // One Invocation per Box Rewrites its Command's instanceCount
+        GLuint const zero[2] = { 0, 0 };
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, mCounterBuffer);
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof zero, zero);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        mCull->activate();
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, mBoxBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, mCommandBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, mCounterBuffer);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, mPyramid);
+        glUniform1i(mPyramidUniform, 0);
+        glUniformMatrix4fv(mViewProjectionUniform, 1, GL_FALSE, & mViewProjection[0][0]);
+        glUniform1ui(mCountUniform, static_cast<GLuint>(mBoxes.size()));
+        glUniform1i(mLevelsUniform, static_cast<GLint>(mSizes.size()));
+        glDispatchCompute((static_cast<GLuint>(mBoxes.size()) + 63) / 64, 1, 1);
+        glMemoryBarrier(GL_COMMAND_BARRIER_BIT);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glUseProgram(0);
+
+        // Stage Counters for a Non-Blocking Read Next Frame
+        if (!mFence)
+        {   glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+            glBindBuffer(GL_COPY_READ_BUFFER, mCounterBuffer);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, mReadback);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, sizeof zero);
+            glBindBuffer(GL_COPY_READ_BUFFER, 0);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+            mFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        }
+    }
+};
@@ -0,0 +1,107 @@
+#pragma once
+
+// System Headers
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+// Local Headers
+#include "shader.hpp"
+
+// Standard Headers
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// Define Namespace
+namespace Mirage
+{
+    // Hierarchical-Z Occlusion Culling Against the Previous Frame's Depth.
+    // Each Frame: test(), Draw Through draw(slot), then capture(viewProjection).
+    class Occlusion
+    {
+    public:
+
+        // Implement Custom Constructor and Destructor
+         Occlusion(GLsizei width, GLsizei height, bool allowCompute = true);
+        ~Occlusion();
+
+        // Register a World-Space Box and the Draw it Guards; Returns its Slot
+        GLuint add(glm::vec3 const & min, glm::vec3 const & max,
+                   GLsizei count, GLenum type, std::size_t offset);
+        void   move(GLuint slot, glm::vec3 const & min, glm::vec3 const & max);
+
+        // Point the Slot's Draw at Another Index Range, e.g. a New LOD
+        void   range(GLuint slot, GLsizei count, std::size_t offset);
+
+        // Test Every Box Against the Last Captured Pyramid (Start of Frame)
+        void test();
+
+        // False if the CPU Path Culled the Slot; the Compute Path Always Says
+        // Yes and Lets the Indirect Command Decide
+        bool visible(GLuint slot) const;
+
+        // Issue the Slot's Draw With its Vertex Array Bound
+        void draw(GLuint slot) const;
+
+        // Snapshot Depth and Rebuild the Pyramid Once Occluders are Drawn
+        void capture(glm::mat4 const & viewProjection);
+
+        // Results of the Latest Test (Lags One Frame on the Compute Path)
+        GLuint drawn()    const { return mDrawn; }
+        GLuint occluded() const { return mOccluded; }
+        bool   compute()  const { return mCompute; }
+
+        // Layouts Shared With the Compute Shaders
+        struct Box     { glm::vec4 min; glm::vec4 max; };
+        struct Command { GLuint count, instanceCount, first; GLint baseVertex; GLuint baseInstance; };
+
+    private:
+
+        // Disable Copying and Assignment
+        Occlusion(Occlusion const &) = delete;
+        Occlusion & operator=(Occlusion const &) = delete;
+
+        // Private Member Functions
+        bool test(Box const & box) const;
+        void buildPyramid();
+        void testCompute();
+
+        // Private Member Containers
+        std::vector<Box> mBoxes;
+        std::vector<Command> mCommands;
+        std::vector<GLenum> mTypes;
+        std::vector<std::size_t> mOffsets;
+        std::vector<unsigned char> mVisible;
+        std::vector<std::vector<float>> mLevels; // CPU Pyramid, Finest First
+        std::vector<glm::ivec2> mSizes;
+
+        // Private Member Variables
+        GLsizei mWidth;
+        GLsizei mHeight;
+        bool mCompute;
+        bool mCaptured = false;
+        bool mDirty    = false;
+        glm::mat4 mViewProjection;
+        GLuint mDrawn    = 0;
+        GLuint mOccluded = 0;
+
+        // Compute Path Objects
+        GLuint mDepth      = 0;
+        GLuint mPyramid    = 0;
+        std::unique_ptr<Shader> mBuild; // hiz_build.comp
+        std::unique_ptr<Shader> mCull;  // hiz_cull.comp
+        GLint mDepthUniform          = -1;
+        GLint mCopyUniform           = -1;
+        GLint mPyramidUniform        = -1;
+        GLint mViewProjectionUniform = -1;
+        GLint mCountUniform          = -1;
+        GLint mLevelsUniform         = -1;
+        GLuint mBoxBuffer     = 0;
+        GLuint mCommandBuffer = 0;
+        std::size_t mUploaded = 0; // Slots the Box and Command Buffers Hold
+        GLuint mCounterBuffer = 0;
+        GLuint mReadback      = 0;
+        GLsync mFence = nullptr;
+
+    };
+};
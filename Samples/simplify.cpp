@@ -0,0 +1,172 @@
+// Local Headers
+#include "simplify.hpp"
+
+// System Headers
+#include <glm/glm.hpp>
+
+// Standard Headers
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+
+// Define Namespace
+namespace Mirage
+{
+    LodSettings & lodSettings()
+    {
+        static LodSettings settings;
+        return settings;
+    }
+
+    // Area-Weighted Sum of Plane Equations as a Symmetric 4x4 Matrix
+    struct Quadric
+    {
+        double a[10] = {};
+        double weight = 0.0;
+
+        void add(glm::vec3 const & n, float d, double area)
+        {
+            double p[4] = { n.x, n.y, n.z, d };
+            for (int i = 0, k = 0; i < 4; i++)
+            for (int j = i; j < 4; j++) a[k++] += p[i] * p[j] * area;
+            weight += area;
+        }
+
+        void add(Quadric const & other)
+        {
+            for (int i = 0; i < 10; i++) a[i] += other.a[i];
+            weight += other.weight;
+        }
+    };
+
+    // Mean Squared Distance from v to the Planes Folded into Either Quadric
+    static double cost(Quadric const & x, Quadric const & y, glm::vec3 const & v)
+    {
+        double p[4] = { v.x, v.y, v.z, 1.0 }, sum = 0.0;
+        for (int i = 0, k = 0; i < 4; i++)
+        for (int j = i; j < 4; j++, k++) sum += (x.a[k] + y.a[k]) * p[i] * p[j] * (i == j ? 1.0 : 2.0);
+        double weight = x.weight + y.weight;
+        return weight > 0.0 ? std::max(sum, 0.0) / weight : 0.0;
+    }
+
+    struct Collapse
+    {
+        GLuint from, to;
+        double cost;
+    };
+
+    std::vector<GLuint> simplify(float const * positions, std::size_t stride, std::size_t vertexCount,
+                                 GLuint const * indices, std::size_t indexCount,
+                                 std::size_t targetCount, float & error)
+    {
+        // Only Triangle Lists Over the Given Vertices Can be Simplified
+        error = 0.0f;
+        bool triangles = indexCount % 3 == 0;
+        for (std::size_t i = 0; i < indexCount && triangles; i++) triangles = indices[i] < vertexCount;
+        if (!triangles) return std::vector<GLuint>(indices, indices + indexCount);
+
+        auto position = [&](GLuint v)
+        {
+            auto p = reinterpret_cast<float const *>(reinterpret_cast<char const *>(positions) + v * stride);
+            return glm::vec3(p[0], p[1], p[2]);
+        };
+        auto normal = [&](GLuint a, GLuint b, GLuint c)
+        {
+            return glm::cross(position(b) - position(a), position(c) - position(a));
+        };
+
+        // Lock Vertices on Edges Not Shared by Exactly Two Triangles. Seams Split
+        // Vertices, so They Show Up Here as Open Borders Too.
+        std::vector<unsigned char> locked(vertexCount, 0);
+        std::unordered_map<std::uint64_t, int> edges;
+        for (std::size_t i = 0; i < indexCount; i += 3)
+        for (int e = 0; e < 3; e++)
+        {   GLuint a = indices[i + e], b = indices[i + (e + 1) % 3];
+            edges[static_cast<std::uint64_t>(std::min(a, b)) << 32 | std::max(a, b)]++;
+        }
+        for (auto &i : edges) if (i.second != 2)
+        {   locked[i.first >> 32] = 1;
+            locked[i.first & 0xffffffff] = 1;
+        }
+
+        // Accumulate the Planes of Each Vertex's Triangles
+        std::vector<Quadric> quadrics(vertexCount);
+        for (std::size_t i = 0; i < indexCount; i += 3)
+        {   glm::vec3 n = normal(indices[i], indices[i + 1], indices[i + 2]);
+            float length = glm::length(n);
+            if (length == 0.0f) continue;
+            n = n / length;
+            float d = -glm::dot(n, position(indices[i]));
+            for (int j = 0; j < 3; j++) quadrics[indices[i + j]].add(n, d, 0.5 * length);
+        }
+
+        std::vector<GLuint> result(indices, indices + indexCount);
+        std::vector<GLuint> remap(vertexCount);
+        std::vector<unsigned char> touched(vertexCount);
+        std::vector<std::size_t> offsets(vertexCount + 1), adjacency;
+        std::vector<Collapse> candidates;
+        double worst = 0.0;
+        while (result.size() > targetCount)
+        {
+            // Every Edge Can Collapse Either Way Unless the Moving End is Locked
+            candidates.clear();
+            for (std::size_t i = 0; i < result.size(); i += 3)
+            for (int e = 0; e < 3; e++)
+            {   GLuint a = result[i + e], b = result[i + (e + 1) % 3];
+                if (!locked[a]) candidates.push_back(Collapse{ a, b, cost(quadrics[a], quadrics[b], position(b)) });
+                if (!locked[b]) candidates.push_back(Collapse{ b, a, cost(quadrics[a], quadrics[b], position(a)) });
+            }
+            std::sort(candidates.begin(), candidates.end(),
+                      [](Collapse const & x, Collapse const & y) { return x.cost < y.cost; });
+
+            // Vertex to Triangle Adjacency, for the Flip Test
+            std::fill(offsets.begin(), offsets.end(), 0);
+            for (auto &i : result) offsets[i + 1]++;
+            for (std::size_t i = 0; i < vertexCount; i++) offsets[i + 1] += offsets[i];
+            adjacency.resize(result.size());
+            std::vector<std::size_t> cursor(offsets.begin(), offsets.end() - 1);
+            for (std::size_t i = 0; i < result.size(); i++) adjacency[cursor[result[i]]++] = i / 3;
+
+            // Take the Cheapest Collapses Whose Neighbourhoods Don't Overlap
+            for (std::size_t i = 0; i < vertexCount; i++) remap[i] = static_cast<GLuint>(i);
+            std::fill(touched.begin(), touched.end(), 0);
+            std::size_t removed = 0, needed = (result.size() - targetCount) / 3;
+            for (auto &c : candidates)
+            {
+                if (removed >= needed) break;
+                if (touched[c.from] || touched[c.to]) continue;
+
+                // Reject Collapses that Would Turn a Surviving Triangle Over
+                bool flips = false; std::size_t collapsing = 0;
+                for (std::size_t j = offsets[c.from]; j < offsets[c.from + 1] && !flips; j++)
+                {   GLuint const * t = & result[adjacency[j] * 3];
+                    if (t[0] == c.to || t[1] == c.to || t[2] == c.to) { collapsing++; continue; }
+                    GLuint moved[3] = { t[0], t[1], t[2] };
+                    for (auto &v : moved) if (v == c.from) v = c.to;
+                    flips = glm::dot(normal(t[0], t[1], t[2]), normal(moved[0], moved[1], moved[2])) <= 0.0f;
+                }
+                if (flips) continue;
+
+                // Apply, and Freeze Every Vertex Around it Until the Next Pass
+                remap[c.from] = c.to;
+                quadrics[c.to].add(quadrics[c.from]);
+                for (std::size_t j = offsets[c.from]; j < offsets[c.from + 1]; j++)
+                for (int k = 0; k < 3; k++) touched[result[adjacency[j] * 3 + k]] = 1;
+                removed += collapsing;
+                worst = std::max(worst, c.cost);
+            }
+            if (removed == 0) break;
+
+            // Rewrite Triangles, Dropping Those that Collapsed to a Line
+            std::size_t count = 0;
+            for (std::size_t i = 0; i < result.size(); i += 3)
+            {   GLuint a = remap[result[i]], b = remap[result[i + 1]], c = remap[result[i + 2]];
+                if (a == b || b == c || a == c) continue;
+                result[count++] = a; result[count++] = b; result[count++] = c;
+            }   result.resize(count);
+        }
+        error = static_cast<float>(std::sqrt(worst));
+        return result;
+    }
+};
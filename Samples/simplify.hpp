@@ -0,0 +1,30 @@
+#pragma once
+
+// System Headers
+#include <glad/glad.h>
+
+// Standard Headers
+#include <cstddef>
+#include <vector>
+
+// Define Namespace
+namespace Mirage
+{
+    // How Meshes Cook and Pick Their Levels of Detail
+    struct LodSettings {
+        std::vector<float> ratios = { 0.5f, 0.25f, 0.125f }; // Index Counts vs. Full Detail
+        std::size_t minimum = 64 * 3;  // Don't Simplify Sub-Meshes Smaller than This
+        float threshold  = 1.0f;       // Largest Acceptable Error, in Pixels
+        float hysteresis = 0.25f;      // Fraction Past the Threshold Before Switching
+    };
+    LodSettings & lodSettings();
+
+    // Quadric Error Edge Collapse Down to About targetCount Indices. Vertices
+    // are Only Ever Collapsed onto Other Existing Vertices, so the Result Indexes
+    // the Same Vertex Data. Open Borders and Attribute Seams Stay Fixed. Writes
+    // the Largest Collapse Error, as a Distance in Object Space, into error.
+    // Anything but a Triangle List of In-Range Indices Comes Back Unchanged.
+    std::vector<GLuint> simplify(float const * positions, std::size_t stride, std::size_t vertexCount,
+                                 GLuint const * indices, std::size_t indexCount,
+                                 std::size_t targetCount, float & error);
+};